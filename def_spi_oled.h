@@ -10,6 +10,8 @@
 #ifndef _DEF_SPI_OLED_H_
 #define _DEF_SPI_OLED_H_
 
+#include <linux/types.h>
+#include <linux/ioctl.h>
 
 /* 设备信息 */
 // SSD1306 的最大 SCLK 频率为 10 MHz，则每个 SCLK 周期为 100 ns
@@ -24,6 +26,14 @@
 #define FRAME_WIDTH 128
 #define FRAME_HEIGHT 64
 #define FRAME_BUFFER_SIZE (FRAME_WIDTH * FRAME_HEIGHT / 8)
+/* 帧缓冲布局：第 y 行位于第 y / 8 页，页内字节的最低位为该页最上面一行（与 GDDRAM 相同，按原顺序传输） */
+#define OLED_PIXEL_MASK(y) (1 << ((y) % 8))
+
+/* 显示方向，由控制器的段重映射（0xA0/0xA1）与 COM 扫描方向（0xC0/0xC8）实现，不改变帧缓冲布局 */
+#define OLED_ORIENT_FLIP_H 0x01     /* 水平镜像 */
+#define OLED_ORIENT_FLIP_V 0x02     /* 垂直镜像 */
+#define OLED_ORIENT_ROTATE_180 (OLED_ORIENT_FLIP_H | OLED_ORIENT_FLIP_V)
+#define OLED_ORIENT_MASK OLED_ORIENT_ROTATE_180
 
 /* gpio 申请标志对应 BIT */
 enum {
@@ -43,6 +53,49 @@ enum {
     IOCTL_OLED_CLEAR = 0x05
 };
 
+/* 新增 ioctl 使用标准编码（_IOW），与上面的旧编号不会冲突 */
+#define OLED_IOC_MAGIC 'o'
+
+/* 批量操作类型，参数均放在 oled_op.arg 中 */
+enum {
+    OLED_OP_NOP = 0x00,
+    OLED_OP_DISPLAY_ON = 0x01,  /* 开启显示（含电荷泵） */
+    OLED_OP_DISPLAY_OFF = 0x02, /* 关闭显示（含电荷泵） */
+    OLED_OP_CONTRAST = 0x03,    /* arg[0]: 对比度 0~255 */
+    OLED_OP_INVERT = 0x04,      /* arg[0]: 1 反相显示，0 正常显示 */
+    OLED_OP_REFRESH = 0x05,     /* 区域刷新 arg[0~3]: x0, x1, page0, page1（闭区间，帧缓冲坐标） */
+    OLED_OP_CLEAR = 0x06,       /* 清空帧缓冲并刷新 */
+    OLED_OP_SCROLL = 0x07,      /* 水平滚动 arg[0~3]: 方向(0 右 1 左), page0, page1, 帧间隔(0~7)，休眠唤醒后自动恢复 */
+    OLED_OP_SCROLL_STOP = 0x08, /* 停止滚动 */
+    OLED_OP_RAW_CMD = 0x09,     /* 原始命令 arg[0 ~ len-1] */
+    OLED_OP_ORIENTATION = 0x0A  /* arg[0]: 显示方向 OLED_ORIENT_*，整屏重新写入 */
+};
+
+/* 单个批量操作 */
+#define OLED_OP_ARG_MAX 14
+struct oled_op {
+    __u8 type;                  /* 操作类型 OLED_OP_* */
+    __u8 len;                   /* OLED_OP_RAW_CMD 的命令字节数 */
+    __u8 arg[OLED_OP_ARG_MAX];  /* 操作参数 */
+};
+
+/* 批量操作描述，ops 为 struct oled_op 数组的用户空间地址 */
+#define OLED_BATCH_MAX 64
+struct oled_batch {
+    __u32 count;    /* 操作个数（不超过 OLED_BATCH_MAX） */
+    __u32 reserved; /* 保留，置 0 */
+    __u64 ops;      /* 操作数组地址 */
+};
+
+/* 按顺序执行一组操作，只加一次锁，连续的区域刷新合并为一次传输 */
+#define IOCTL_OLED_BATCH _IOW(OLED_IOC_MAGIC, 0x10, struct oled_batch)
+
+/* 设置 write/splice 帧流的显示帧率（__u32，0 表示不限速，收到整帧立即显示） */
+#define IOCTL_OLED_SET_FPS _IOW(OLED_IOC_MAGIC, 0x11, __u32)
+
+/* 设置显示方向（__u32，OLED_ORIENT_* 组合），立即重新写入整屏 */
+#define IOCTL_OLED_SET_ORIENTATION _IOW(OLED_IOC_MAGIC, 0x12, __u32)
+
 /* gpio 电平 */
 enum {
     GPIO_LOW = 0,
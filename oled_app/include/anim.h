@@ -0,0 +1,69 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 18:05:44
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 18:05:44
+ * @Description: 动画容器（.ola），mmap 加载，关键帧直接复制，差分帧按 XOR 游程解码到帧缓冲
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _ANIM_H_
+#define _ANIM_H_
+
+#include "page.h"
+
+/*
+ * 文件布局（小端）：
+ *   OlaHeader
+ *   OlaFrame[count]     帧索引
+ *   帧数据
+ * 帧数据与帧缓冲布局相同（FRAME_BUFFER_SIZE 字节，位序与帧缓冲一致，位序变化时 OLA_VERSION 加一）
+ *   OLA_FRAME_RAW:   完整的一帧
+ *   OLA_FRAME_DELTA: 与上一帧的 XOR 差分，由若干记录组成：
+ *                    [跳过的字节数 u8][变化的字节数 u8][变化的字节 XOR 值...]
+ *                    跳过超过 255 字节时使用变化字节数为 0 的记录
+ * 第一帧必须是 OLA_FRAME_RAW，循环播放时从第一帧重新开始
+ */
+#define OLA_MAGIC   0x31414C4F  // "OLA1"
+#define OLA_VERSION 2
+
+/* 帧类型 */
+enum {
+    OLA_FRAME_RAW,
+    OLA_FRAME_DELTA
+};
+
+/* 文件头 */
+typedef struct {
+    uint32_t magic;         // OLA_MAGIC
+    uint8_t version;        // OLA_VERSION
+    uint8_t reserved[3];
+    uint32_t count;         // 帧数
+    uint32_t index_offset;  // 帧索引在文件中的偏移
+} OlaHeader;
+
+/* 帧索引项 */
+typedef struct {
+    uint32_t offset;        // 帧数据在文件中的偏移
+    uint32_t size;          // 帧数据大小
+    uint32_t duration_ms;   // 显示时长
+    uint8_t type;           // 帧类型
+    uint8_t reserved[3];
+} OlaFrame;
+
+/* 动画播放器 */
+typedef struct {
+    const uint8_t *base;    // 映射地址
+    size_t size;            // 文件大小
+    const OlaHeader *header;
+    const OlaFrame *frames;
+    uint32_t next;          // 下一帧
+    size_t released;        // 已经释放的映射范围
+} AnimPlayer;
+
+int anim_open(AnimPlayer *anim, const char *path);
+void anim_close(AnimPlayer *anim);
+void anim_rewind(AnimPlayer *anim);
+int anim_next(AnimPlayer *anim, uint8_t *frame_buffer, Rect *damage, int max_damage, uint32_t *duration_ms);
+
+#endif
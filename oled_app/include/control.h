@@ -0,0 +1,43 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 21:48:25
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 21:48:25
+ * @Description: 本地控制 socket，运行中切换界面、修改文本和刷新间隔、显示提示，不需要重启程序
+ *               每行一条命令，回复 "ok" 或 "error: ..."，例如：
+ *               echo "page 2" | socat - UNIX-CONNECT:/tmp/spi_oled_app.sock
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _CONTROL_H_
+#define _CONTROL_H_
+
+/* 默认的控制 socket 路径 */
+#define CONTROL_SOCKET_PATH "/tmp/spi_oled_app.sock"
+/* 命令中文本的最大长度（与控件文本长度一致） */
+#define CONTROL_TEXT_MAX 32
+/* 一行命令的最大长度 */
+#define CONTROL_LINE_MAX 128
+/* 一次读取最多解析出的命令数（一行至少 5 个字节，不会超过） */
+#define CONTROL_MAX_CMDS (CONTROL_LINE_MAX / 4)
+
+/* 控制命令 */
+typedef enum {
+    CONTROL_PAGE,           // page <1~3>：切换界面
+    CONTROL_TEXT,           // text <string>：修改界面 1 的文本
+    CONTROL_INTERVAL,       // interval <ms>：修改最短刷新间隔
+    CONTROL_ALERT           // alert <seconds> [message]：显示提示，0 秒关闭
+} ControlType;
+
+/* 解析后的控制命令 */
+typedef struct {
+    int type;               // 命令类型 ControlType
+    int value;              // 界面编号 / 间隔（ms） / 提示时长（秒）
+    char text[CONTROL_TEXT_MAX]; // 文本 / 提示内容
+} ControlCmd;
+
+int control_open(const char *path, int epfd);
+void control_close(void);
+int control_handle(int epfd, int fd, ControlCmd *cmds, int max_cmds);
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 15:20:47
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 15:20:47
+ * @Description: 外部点阵字库（.olf），mmap 加载，按码位二分查找
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _FONT_H_
+#define _FONT_H_
+
+#include "page.h"
+
+/*
+ * 文件布局（小端）：
+ *   OlfHeader
+ *   OlfGlyph[count]     按 code 升序排列的索引
+ *   字模数据            每个字 pages * width 字节，按页存放，每页一行连续 width 字节（与 FontStrip 相同）
+ * 字节内的位序与帧缓冲一致，位序变化时 OLF_VERSION 加一
+ */
+#define OLF_MAGIC   0x31464C4F  // "OLF1"
+#define OLF_VERSION 2
+
+/* 文件头 */
+typedef struct {
+    uint32_t magic;         // OLF_MAGIC
+    uint8_t version;        // OLF_VERSION
+    uint8_t height;         // 字高
+    uint8_t pages;          // 每个字占用的页数
+    uint8_t reserved;
+    uint32_t count;         // 字符个数
+    uint32_t index_offset;  // 索引在文件中的偏移
+    uint32_t data_offset;   // 字模数据在文件中的偏移
+} OlfHeader;
+
+/* 索引项 */
+typedef struct {
+    uint32_t code;          // Unicode 码位
+    uint32_t offset;        // 字模相对 data_offset 的偏移
+    uint8_t width;          // 字宽
+    uint8_t reserved[3];
+} OlfGlyph;
+
+/* 已加载的字库 */
+typedef struct {
+    const uint8_t *base;    // 映射地址
+    size_t size;            // 文件大小
+    const OlfHeader *header;
+    const OlfGlyph *glyphs;
+    const uint8_t *data;
+} OlfFont;
+
+int font_open(OlfFont *font, const char *path);
+void font_close(OlfFont *font);
+const OlfGlyph *font_find(const OlfFont *font, uint32_t code);
+uint32_t utf8_next(const uint8_t **p);
+void OLED_SetFont(const OlfFont *font);
+
+/**
+ * @Description: 取得字模数据
+ * @param {const OlfFont} *font: 字库
+ * @param {const OlfGlyph} *glyph: font_find 返回的索引项
+ * @return {*}
+ */
+static inline const uint8_t *font_bitmap(const OlfFont *font, const OlfGlyph *glyph) {
+    return font->data + glyph->offset;
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 23:02:37
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 23:02:37
+ * @Description: 原始视频输入（--stdin-format），从管道读取 FRAME_WIDTH x FRAME_HEIGHT 的逐行原始帧
+ *               ffmpeg -re -i in.mp4 -vf scale=128:64 -f rawvideo -pix_fmt gray - | spi_oled_app --stdin-format gray8
+ *               输入非阻塞读取，每次把管道中已有的数据全部读完，只保留最新的一帧，
+ *               屏幕跟不上时中间的帧被丢弃，不会在程序里排队
+ *               每次最多读调用时管道中已有的数据，写入方持续写满管道时也能及时返回显示
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _INGEST_H_
+#define _INGEST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* 无法得知管道中已有多少数据时，一次 ingest_read 最多读取的帧数 */
+#define INGEST_MAX_FRAMES 3
+
+/* 输入读取器 */
+typedef struct {
+    int fd;                 // 输入，读取期间为非阻塞
+    int format;             // 像素格式 PixFormat
+    int stride;             // 每行的字节数
+    size_t frame_bytes;     // 一帧的字节数
+    uint8_t *buf;           // 正在接收的帧
+    size_t fill;            // buf 中已接收的字节数
+    uint8_t *latest;        // 最新的完整帧
+    int pending;            // latest 还没有显示
+    int file;               // 输入是普通文件：没有发送速率，每次只读一帧，不丢帧
+    int eof;                // 输入已结束
+    unsigned long received; // 收到的完整帧数
+    unsigned long dropped;  // 没有显示就被新帧覆盖的帧数
+} IngestReader;
+
+int ingest_open(IngestReader *in, int fd, int format);
+void ingest_close(IngestReader *in);
+int ingest_read(IngestReader *in);
+
+#endif
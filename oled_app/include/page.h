@@ -19,6 +19,75 @@
 typedef unsigned char uint8_t;
 typedef unsigned int  uint32_t;
 
+/* 页内字节的位操作，最低位为该页最上面一行（与 OLED_PIXEL_MASK 一致） */
+#define OLED_BYTE_DOWN(b, s) ((uint8_t)((b) << (s)))   // 内容向下（y 增大方向）移动 s 行
+#define OLED_BYTE_UP(b, s)   ((uint8_t)((b) >> (s)))   // 内容向上移动 s 行
+#define OLED_TOP_ROWS(n)     ((uint8_t)(0xFF >> (8 - (n)))) // 最上面 n 行（1~8）的掩码
+#define OLED_ROWS_MASK(r0, r1) OLED_BYTE_DOWN(OLED_TOP_ROWS((r1) - (r0) + 1), r0) // 页内第 r0~r1 行的掩码
+
+/**
+ * @Description: 字节内位序反转，取模软件的“顺向”（最高位在上）字节转换为帧缓冲字节
+ * @param {uint8_t} b: 源字节
+ * @return {*}
+ */
+static inline uint8_t OLED_ReverseByte(uint8_t b)
+{
+    b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+    b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+    return (b & 0xAA) >> 1 | (b & 0x55) << 1;
+}
+
+/* 页式字模（构建时由 tools/fontgen 从 oledfont.h 生成）
+   每个字按页存放，每页一行连续 width 字节，布局与帧缓冲一致 */
+typedef struct {
+    uint8_t height;         // 字高
+    uint8_t pages;          // 每个字占用的页数
+    uint8_t width;          // 每页一行的字节数（最大字宽）
+    uint8_t first;          // 第一个字符的编码
+    uint8_t count;          // 字符个数
+    const uint8_t *widths;  // 每个字的宽度
+    const uint8_t *data;    // 字模数据，每个字 pages * width 字节
+} FontStrip;
+
+/* 批量绘制的图元类型 */
+typedef enum {
+    DRAW_POINT,             // 点 (x0, y0)
+    DRAW_HLINE,             // 水平线 x0~x1, y0
+    DRAW_VLINE,             // 垂直线 x0, y0~y1
+    DRAW_LINE,              // 任意直线 (x0, y0)~(x1, y1)
+    DRAW_RECT,              // 矩形边框
+    DRAW_FILL,              // 填充矩形
+    DRAW_CIRCLE,            // 圆 圆心 (x0, y0) 半径 r
+    DRAW_FILL_CIRCLE,       // 实心圆
+    DRAW_ROUND_RECT,        // 圆角矩形边框，圆角半径 r
+    DRAW_FILL_ROUND_RECT    // 实心圆角矩形
+} DrawOp;
+
+/* 批量绘制的单个图元 */
+typedef struct {
+    uint8_t op;             // 图元类型 DrawOp
+    uint8_t point;          // 1 填充 0,清空
+    short x0, y0, x1, y1;   // 坐标（闭区间，可以超出屏幕，会被裁剪）
+    short r;                // 半径
+} DrawCmd;
+
+/* 屏幕上的矩形区域（闭区间），用于描述需要发送给屏幕的脏区域 */
+typedef struct {
+    short x0, y0, x1, y1;
+} Rect;
+
+/* 绘制目标：页式 1bpp 位图，布局与帧缓冲相同
+   第 p 页第 x 列的字节为 data[p * stride + x]，第 y 行是该字节的 OLED_PIXEL_MASK(y) 位 */
+typedef struct {
+    uint8_t *data;          // 页式数据
+    short width;            // 宽度（像素）
+    short height;           // 高度（像素），按 8 行一页向上取整存放
+    short stride;           // 相邻两页的字节间隔（不小于 width）
+} Surface;
+
+/* 界面个数 */
+#define PAGE_COUNT 3
+
 /* 字体大小 */
 enum {
     FONT_12 = 12,
@@ -26,6 +95,39 @@ enum {
     FONT_24 = 24
 };
 
-void display_ui(int page, char *frame_buffer, size_t frame_size);
+void OLED_BlitColumns(Surface *s, int x, int y, const uint8_t *src, int w, int h,
+                      int col_stride, int page_stride, uint8_t point);
+int OLED_ShowGlyph(Surface *s, int x, int y, const FontStrip *font, int code, uint8_t point);
+void OLED_ShowChar(Surface *s, uint8_t x, uint8_t y, uint8_t chr, uint8_t size, uint8_t point);
+void OLED_ShowNum(Surface *s, uint8_t x, uint8_t y, uint32_t num, uint8_t len, uint8_t size);
+void OLED_ShowString(Surface *s, uint8_t x, uint8_t y, const uint8_t *p, uint8_t size);
+int OLED_StringWidth(const uint8_t *p, uint8_t size);
+int OLED_ShowStringClip(Surface *s, int x, int y, const uint8_t *p, uint8_t size, int max_w);
+void OLED_Clear(Surface *s);
+void OLED_Fill(Surface *s, int x1, int y1, int x2, int y2, uint8_t point);
+void OLED_ShiftRows(Surface *s, int x1, int y1, int x2, int y2, int n);
+void OLED_ShiftColumns(Surface *s, int x1, int y1, int x2, int y2, int n);
+void OLED_Invert(Surface *s, int x1, int y1, int x2, int y2);
+void OLED_MergeMasked(uint8_t *dst, const uint8_t *src, const uint8_t *mask, size_t n);
+uint32_t OLED_PopCount(const uint8_t *buf, size_t n);
+uint32_t OLED_DiffCount(const uint8_t *a, const uint8_t *b, size_t n);
+int OLED_PageDamage(const short *x0, const short *x1, Rect *damage, int max_damage);
+int OLED_DiffDamage(const uint8_t *old, const uint8_t *cur, Rect *damage, int max_damage);
+void OLED_DrawHLine(Surface *s, int x1, int x2, int y, uint8_t point);
+void OLED_DrawVLine(Surface *s, int x, int y1, int y2, uint8_t point);
+void OLED_DrawLine(Surface *s, int x0, int y0, int x1, int y1, uint8_t point);
+void OLED_DrawRect(Surface *s, int x1, int y1, int x2, int y2, uint8_t point);
+void OLED_DrawCircle(Surface *s, int xc, int yc, int r, uint8_t point);
+void OLED_FillCircle(Surface *s, int xc, int yc, int r, uint8_t point);
+void OLED_DrawRoundRect(Surface *s, int x1, int y1, int x2, int y2, int r, uint8_t point);
+void OLED_FillRoundRect(Surface *s, int x1, int y1, int x2, int y2, int r, uint8_t point);
+void OLED_DrawList(Surface *s, const DrawCmd *cmds, int count);
+int OLED_SetRotation(int degrees);
+void display_set_text(const char *text);
+void display_set_alert(const char *text);
+void display_schedule(int page);
+const uint8_t *display_page(int page, Rect *damage, int max_damage, int *count);
+const uint8_t *display_frame(int page, Rect *damage, int max_damage, int *count);
+int display_ui(int page, char *frame_buffer, size_t frame_size, Rect *damage, int max_damage);
 
 #endif
\ No newline at end of file
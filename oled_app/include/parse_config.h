@@ -15,8 +15,17 @@
 typedef struct {
     char *oled_pins; // 控制引脚
     int page;        // 显示主页
-    int interval;    // 更新间隔（ms毫秒）
+    int interval;    // 最短更新间隔（ms毫秒），0 表示各数据项按自己的周期更新
     char *text;      // 显示文本
+    char *font;      // 外部字库文件（.olf）
+    char *anim;      // 动画文件（.ola），指定时播放动画代替界面
+    int carousel;    // 轮播间隔（秒），0 表示不轮播
+    int transition;  // 轮播切换方式 TransitionType
+    int rotate;      // 旋转角度 0/90/180/270
+    int flip;        // 镜像 OLED_ORIENT_FLIP_H/OLED_ORIENT_FLIP_V 组合
+    char *socket;    // 控制 socket 路径
+    int server;      // 是否作为显示服务，合成其他进程的图层
+    int stdin_format; // 从标准输入读取原始视频的像素格式 PixFormat，-1 表示不读取
     int verbose;     // 是否显示详细信息
 } AppConfig;
 
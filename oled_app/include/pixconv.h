@@ -0,0 +1,72 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 19:30:12
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 19:30:12
+ * @Description: 像素格式转换，把逐行存放的灰度/RGB565/RGB24/RGBA/单色图转换为帧缓冲的页式 1bpp 布局
+ *               阈值和有序抖动、颜色转灰度有 SSE2/AVX2/NEON 实现，其他平台使用标量实现
+ *               每种转换都有 _scalar 参考实现，make test 在随机输入上比较两者，img2oled -C 逐帧比较实际素材
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _PIXCONV_H_
+#define _PIXCONV_H_
+
+#include <stdint.h>
+
+#include "page.h"
+
+/* 输入像素格式，均为逐行存放 */
+typedef enum {
+    PIX_FMT_GRAY8,          // 8 位灰度
+    PIX_FMT_RGB565,         // 16 位 RGB565，小端
+    PIX_FMT_RGBA8888,       // 32 位，字节顺序 R G B A，alpha 作为覆盖率与黑色背景混合
+    PIX_FMT_MONO,           // 1 位单色，每字节最高位为最左边的像素（PBM P4），1 点亮
+    PIX_FMT_RGB888,         // 24 位，字节顺序 R G B
+    PIX_FMT_COUNT
+} PixFormat;
+
+/* 抖动方式 */
+typedef enum {
+    PIX_THRESHOLD,          // 固定阈值
+    PIX_ORDERED,            // 8x8 Bayer 有序抖动
+    PIX_FLOYD_STEINBERG     // Floyd-Steinberg 误差扩散
+} PixDither;
+
+/* 转换参数 */
+typedef struct {
+    uint8_t dither;         // 抖动方式 PixDither
+    uint8_t threshold;      // 阈值（PIX_THRESHOLD 和 PIX_FLOYD_STEINBERG），灰度大于阈值时点亮
+    uint8_t hysteresis;     // 时间稳定滤波：上一帧点亮的像素阈值降低，熄灭的像素阈值升高，减少闪烁（0 关闭）
+} PixConfig;
+
+/**
+ * @Description: 8x8 位矩阵转置，输入第 j 字节的第 i 位成为输出第 i 字节的第 j 位（字节 0 为最低字节）
+ *               逐行的 8 个字节（每字节 8 列）转置后即为页式布局的 8 列（每字节 8 行）
+ * @param {uint64_t} x: 8 个字节
+ * @return {*}
+ */
+static inline uint64_t pixconv_transpose8x8(uint64_t x)
+{
+    uint64_t t;
+
+    // 依次交换 1x1、2x2、4x4 的子块
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+int pixconv_format_parse(const char *name);
+int pixconv_row_bytes(int format, int width);
+void pixconv_to_gray(const void *src, int stride, int format, int width, int height, uint8_t *gray, int gray_stride);
+void pixconv_to_gray_scalar(const void *src, int stride, int format, int width, int height, uint8_t *gray, int gray_stride);
+void pixconv_image(const void *src, int stride, int format, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg);
+void pixconv_image_scalar(const void *src, int stride, int format, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg);
+void pixconv_gray8(const uint8_t *gray, int stride, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg);
+void pixconv_gray8_scalar(const uint8_t *gray, int stride, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg);
+
+#endif
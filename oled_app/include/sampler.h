@@ -0,0 +1,64 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 16:35:09
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 16:35:09
+ * @Description: 硬件状态采样，文件只打开一次，每次用 pread 重新读取，不创建进程也不分配内存
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _SAMPLER_H_
+#define _SAMPLER_H_
+
+#include <stdatomic.h>
+
+/* NPU 最多的核心数 */
+#define SAMPLER_NPU_CORES 3
+/* 每个数据来源最多发布的数值个数 */
+#define SAMPLER_VALUES_MAX SAMPLER_NPU_CORES
+
+/* 历史记录长度（2 的幂，不小于屏幕宽度） */
+#define SAMPLER_HISTORY 128
+
+/* 数据来源，每个来源在自己的线程中按自己的周期采样 */
+typedef enum {
+    SAMPLE_CPU,         // CPU 占用率（0.01%）
+    SAMPLE_CPU_FREQ,    // CPU 频率（MHz）
+    SAMPLE_GPU,         // GPU 占用率（%）
+    SAMPLE_NPU,         // NPU 各核心占用率（%）
+    SAMPLE_TEMP,        // 芯片温度（0.001°C）
+    SAMPLE_SOURCES
+} SampleSource;
+
+int sampler_init(void);
+void sampler_close(void);
+int sample_cpu_usage(void);
+int sample_cpu_frequency(void);
+int sample_gpu_load(void);
+int sample_npu_load(int *loads, int max);
+int sample_temperature(int *millicelsius);
+
+/* 采样历史环形缓冲，采样线程写入，界面直接读取
+   多个数值的来源（NPU）记录平均值 */
+typedef struct {
+    atomic_uint head;                       // 写入的总次数，下一个写入位置为 head % SAMPLER_HISTORY
+    atomic_int data[SAMPLER_HISTORY];
+} SampleHistory;
+
+/**
+ * @Description: 读取第 index 次写入的历史值
+ * @param {SampleHistory} *h: 历史记录
+ * @param {unsigned} index: 写入序号（小于 head，且不早于 head - SAMPLER_HISTORY）
+ * @return {*}
+ */
+static inline int history_at(SampleHistory *h, unsigned index) {
+    return atomic_load_explicit(&h->data[index % SAMPLER_HISTORY], memory_order_relaxed);
+}
+
+int sampler_start(void);
+void sampler_stop(void);
+int sampler_latest(int source, int *values, int max);
+int sampler_period(int source);
+SampleHistory *sampler_history(int source);
+
+#endif
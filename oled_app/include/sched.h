@@ -0,0 +1,37 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 23:31:52
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 23:31:52
+ * @Description: 多周期调度，每个数据项声明自己的周期和耗时，主循环只在最早到期的项需要运行时醒来
+ *               到期时间相近的项合并到同一次唤醒中运行，所有项都没有改变可见内容时不绘制这一帧
+ *               时间使用 CLOCK_REALTIME，按周期对齐的项（时钟）在整秒上更新
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _SCHED_H_
+#define _SCHED_H_
+
+/* 最多的调度项 */
+#define SCHED_MAX_ITEMS 16
+/* 合并窗口上限：项可以提前或推迟的最大时间（ms），实际为周期的 1/8 与它的较小值 */
+#define SCHED_SLACK_MAX_MS 50
+/* 一次唤醒中提前运行的项的耗时预算（us），到期的项不受限制 */
+#define SCHED_BUDGET_US 2000
+
+/* 调度项标志 */
+#define SCHED_ALIGN     0x01    // 到期时间对齐到周期的整数倍（墙上时间），准时运行，不提前也不推迟
+
+/* 运行函数，返回 1 表示可见内容变化，0 没有变化，-1 出错 */
+typedef int (*SchedFunc)(void *arg);
+
+int sched_add(const char *name, int period_ms, int cost_us, int flags, SchedFunc run, void *arg);
+void sched_enable(int id, int enable);
+void sched_set_period(int id, int period_ms);
+void sched_set_min_period(int period_ms);
+void sched_reset(void);
+long long sched_next(void);
+int sched_run(void);
+void sched_print_stats(void);
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 22:20:14
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 22:20:14
+ * @Description: 多客户端显示服务（--server），spi_oled_app 独占 /dev/spi_oled，其他进程通过 Unix socket 申请屏幕区域
+ *               每个客户端得到一块 memfd 共享内存作为图层（页式 1bpp，stride 为区域宽度），
+ *               画完后只发送脏矩形，socket 上不传像素；服务按优先级合成，只把变化的区域发送给驱动
+ *               客户端流程：连接 SERVER_SOCKET_PATH（SOCK_SEQPACKET）-> SERVER_CREATE -> 收到带 memfd 的 SERVER_REPLY
+ *               -> mmap 后绘制 -> SERVER_DAMAGE -> ...，断开连接即释放区域
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _SERVER_H_
+#define _SERVER_H_
+
+#include <stdint.h>
+
+#include "page.h"
+
+/* 显示服务的 socket 路径 */
+#define SERVER_SOCKET_PATH "/tmp/spi_oled_server.sock"
+/* 同时存在的图层（客户端）个数 */
+#define SERVER_MAX_LAYERS 8
+
+/* 消息类型 */
+typedef enum {
+    SERVER_CREATE = 1,      // 客户端 -> 服务：申请屏幕区域 x/y/w/h，priority 越大越靠上
+    SERVER_DAMAGE,          // 客户端 -> 服务：图层中 x/y/w/h（图层坐标）已画完，需要刷新
+    SERVER_REPLY            // 服务 -> 客户端：CREATE 的结果，成功时附带 memfd（SCM_RIGHTS）
+} ServerMsgType;
+
+/* 图层标志 */
+#define SERVER_LAYER_OR 0x01    // 只点亮像素，透出下面的内容（默认不透明，覆盖整个区域）
+
+/* 消息，SOCK_SEQPACKET 保留消息边界，每次收发一条 */
+typedef struct {
+    uint32_t type;          // 消息类型 ServerMsgType
+    int32_t status;         // REPLY：0 成功，负数为 -errno
+    int16_t x, y, w, h;     // 区域
+    int16_t priority;       // CREATE：优先级
+    uint16_t flags;         // CREATE：图层标志
+    uint32_t size;          // REPLY：共享内存大小，(h + 7) / 8 * w 字节
+} ServerMsg;
+
+int server_open(const char *path, int epfd);
+void server_close(void);
+int server_handle(int epfd, int fd);
+int server_compose(const uint8_t *base, const Rect *base_damage, int base_count,
+                   uint8_t *frame_buffer, Rect *damage, int max_damage);
+
+#endif
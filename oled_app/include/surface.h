@@ -0,0 +1,32 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 21:06:40
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 21:06:40
+ * @Description: 离屏绘制目标与光栅操作合成
+ *               控件和图层先画在各自的 Surface 中，再按光栅操作合成，最后只把变化的字节发布到帧缓冲
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _SURFACE_H_
+#define _SURFACE_H_
+
+#include "page.h"
+
+/* 光栅操作 */
+typedef enum {
+    ROP_COPY,               // dst = src
+    ROP_OR,                 // dst |= src，叠加点亮的像素
+    ROP_AND,                // dst &= src
+    ROP_XOR,                // dst ^= src，反色叠加，再画一次即可擦除
+    ROP_MASKED              // 掩码为 1 的像素 dst = src，其余不变（带透明的图标）
+} RasterOp;
+
+void surface_init(Surface *s, uint8_t *data, int width, int height, int stride);
+int surface_create(Surface *s, int width, int height);
+void surface_destroy(Surface *s);
+void surface_blit(Surface *dst, int dx, int dy, const Surface *src, int sx, int sy, int w, int h,
+                  int op, const Surface *mask);
+int surface_publish(Surface *dst, const Surface *src, Rect *damage, int max_damage);
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 21:10:03
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 21:10:03
+ * @Description: 界面切换动画，由两个离屏界面合成过渡帧
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _TRANSITION_H_
+#define _TRANSITION_H_
+
+#include "page.h"
+
+/* 切换方式 */
+typedef enum {
+    TRANSITION_NONE,    // 直接切换
+    TRANSITION_SLIDE,   // 新界面从右边推入
+    TRANSITION_WIPE,    // 新界面从左到右逐列覆盖
+    TRANSITION_PUSH,    // 新界面从下面推入
+    TRANSITION_FADE     // 按 Bayer 矩阵逐点溶解
+} TransitionType;
+
+/* 切换动画的帧数和帧间隔（约 30 FPS，0.4 秒），TRANSITION_NONE 只有最后一帧 */
+#define TRANSITION_STEPS 12
+#define TRANSITION_FRAME_NS 33333333L
+
+int transition_parse(const char *name);
+int transition_frame(int type, const uint8_t *from, const uint8_t *to, int step, int steps,
+                     uint8_t *frame_buffer, Rect *damage, int max_damage);
+
+#endif
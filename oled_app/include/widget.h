@@ -0,0 +1,64 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 14:02:31
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 14:02:31
+ * @Description: 保留模式控件，记住上次渲染的内容，只重绘变化的部分并输出脏矩形
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _WIDGET_H_
+#define _WIDGET_H_
+
+#include "page.h"
+#include "sampler.h"
+
+#define WIDGET_TEXT_MAX 32
+
+/* 控件类型 */
+typedef enum {
+    WIDGET_LABEL,   // 文本标签
+    WIDGET_NUMBER,  // 定宽数字
+    WIDGET_BAR,     // 进度条（0~100）
+    WIDGET_ICON,    // 图标
+    WIDGET_SPARKLINE, // 滚动折线图（采样历史）
+    WIDGET_BARGRAPH   // 滚动柱状图（采样历史）
+} WidgetType;
+
+/* 控件 */
+typedef struct {
+    uint8_t type;           // 控件类型 WidgetType
+    uint8_t font;           // 字体大小（标签/数字）
+    short x, y;             // 左上角坐标
+    short w, h;             // 宽高（进度条/图标）
+    short digits;           // 数字位数
+    char text[WIDGET_TEXT_MAX]; // 标签文本
+    int value;              // 数字/进度条数值
+    const uint8_t *icon;    // 图标点阵（页式，每页 w 字节）
+    uint8_t source;         // 图表的数据来源 SampleSource
+    int lo, hi;             // 图表纵轴范围（采样值的单位）
+
+    /* 上次渲染的状态 */
+    char shown[WIDGET_TEXT_MAX];
+    short shown_width;      // 上次显示的文本宽度
+    int shown_value;
+    const uint8_t *shown_icon;
+    unsigned drawn;         // 图表已画到的历史序号
+    uint8_t rendered;       // 是否已渲染过
+} Widget;
+
+/* 控件初始化 */
+#define WIDGET_LABEL_INIT(_x, _y, _font)        { .type = WIDGET_LABEL, .font = (_font), .x = (_x), .y = (_y) }
+#define WIDGET_NUMBER_INIT(_x, _y, _font, _dig) { .type = WIDGET_NUMBER, .font = (_font), .x = (_x), .y = (_y), .digits = (_dig) }
+#define WIDGET_BAR_INIT(_x, _y, _w, _h)         { .type = WIDGET_BAR, .x = (_x), .y = (_y), .w = (_w), .h = (_h) }
+#define WIDGET_ICON_INIT(_x, _y, _w, _h)        { .type = WIDGET_ICON, .x = (_x), .y = (_y), .w = (_w), .h = (_h) }
+#define WIDGET_GRAPH_INIT(_type, _x, _y, _w, _h, _src, _lo, _hi) \
+    { .type = (_type), .x = (_x), .y = (_y), .w = (_w), .h = (_h), .source = (_src), .lo = (_lo), .hi = (_hi) }
+
+int widget_set_text(Widget *w, const char *text);
+int widget_set_value(Widget *w, int value);
+int widget_set_icon(Widget *w, const uint8_t *icon);
+void widget_invalidate(Widget *widgets, int count);
+int widget_render(Surface *s, Widget *widgets, int count, Rect *damage, int max_damage);
+
+#endif
@@ -6,15 +6,28 @@
 #include <errno.h>
 #include <stdint.h>
 #include <signal.h>
-#include <poll.h>
 #include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 #include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <poll.h>
+#include <time.h>
 
 #include "../def_spi_oled.h"
 #include "include/parse_config.h"
 #include "include/page.h"
+#include "include/font.h"
+#include "include/sampler.h"
+#include "include/anim.h"
+#include "include/transition.h"
+#include "include/control.h"
+#include "include/server.h"
+#include "include/ingest.h"
+#include "include/pixconv.h"
+#include "include/surface.h"
+#include "include/sched.h"
 
 /* 帧缓冲 */
 char *oled_framebuffer = NULL;
@@ -24,6 +37,385 @@ AppConfig config;
 int fd;
 /* 帧缓冲大小 */
 size_t buffer_size;
+/* 外部字库 */
+OlfFont font;
+
+/* 每帧最多提交的脏矩形个数 */
+#define MAX_DAMAGE 8
+
+/*********************************** 刷新 *********************************/
+/**
+ * @Description: 把脏矩形转换成局部刷新操作，一次 ioctl 提交给驱动
+ * @param {Rect} *damage: 脏矩形
+ * @param {int} count: 脏矩形个数
+ * @return {*} ioctl 返回值
+ */
+static int oled_flush_damage(const Rect *damage, int count) {
+    struct oled_op ops[MAX_DAMAGE];
+    struct oled_batch batch;
+
+    for (int i = 0; i < count; i++) {
+        ops[i] = (struct oled_op){ .type = OLED_OP_REFRESH, .len = 4 };
+        ops[i].arg[0] = damage[i].x0;
+        ops[i].arg[1] = damage[i].x1;
+        ops[i].arg[2] = damage[i].y0 / 8;   // 矩形覆盖的页
+        ops[i].arg[3] = damage[i].y1 / 8;
+    }
+    batch.count = count;
+    batch.reserved = 0;
+    batch.ops = (uintptr_t)ops;
+    return ioctl(fd, IOCTL_OLED_BATCH, &batch);
+}
+
+/*********************************** 动画 *********************************/
+/**
+ * @Description: 按每帧的时长播放动画，落后时丢弃过期的帧（仍然解码），赶上后整屏刷新一次
+ * @param {const char} *path: 动画文件
+ * @return {*} 出错时返回 -1
+ */
+static int play_animation(const char *path) {
+    AnimPlayer anim;
+    Rect damage[MAX_DAMAGE];
+    struct timespec next, now;
+    uint32_t duration;
+    int count, stale = 0, ret = 0;
+
+    if (anim_open(&anim, path) < 0)
+        return -1;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (1) {
+        count = anim_next(&anim, (uint8_t *)oled_framebuffer, damage, MAX_DAMAGE, &duration);
+        if (count < 0) {
+            fprintf(stderr, "Corrupt animation frame\n");
+            ret = -1;
+            break;
+        }
+
+        // 这一帧的结束时间
+        next.tv_sec += duration / 1000;
+        next.tv_nsec += (duration % 1000) * 1000000L;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > next.tv_sec || (now.tv_sec == next.tv_sec && now.tv_nsec >= next.tv_nsec)) {
+            stale = 1; // 已经过期，不发送
+            continue;
+        }
+
+        if (stale) {
+            damage[0] = (Rect){ 0, 0, FRAME_WIDTH - 1, FRAME_HEIGHT - 1 };
+            count = 1;
+            stale = 0;
+        }
+        if (count > 0 && oled_flush_damage(damage, count) < 0) {
+            perror("ioctl failed: IOCTL_OLED_BATCH");
+            ret = -1;
+            break;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+    anim_close(&anim);
+    return ret;
+}
+
+/*********************************** 轮播 *********************************/
+/**
+ * @Description: 播放界面切换动画，两个界面在各自的离屏缓冲中继续更新
+ * @param {int} from: 旧界面
+ * @param {int} to: 新界面
+ * @return {*} 出错时返回 -1
+ */
+static int run_transition(int from, int to) {
+    Rect damage[MAX_DAMAGE];
+    struct timespec next;
+    // 直接切换只发送最后一帧，不在主循环里等待
+    int steps = config.transition == TRANSITION_NONE ? 1 : TRANSITION_STEPS;
+    int count;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (int step = 1; step <= steps; step++) {
+        const uint8_t *a = display_page(from, damage, MAX_DAMAGE, &count);
+        const uint8_t *b = display_page(to, damage, MAX_DAMAGE, &count);
+
+        if (!a || !b)
+            return -1;
+        count = transition_frame(config.transition, a, b, step, steps,
+                                 (uint8_t *)oled_framebuffer, damage, MAX_DAMAGE);
+        if (count > 0 && oled_flush_damage(damage, count) < 0) {
+            perror("ioctl failed: IOCTL_OLED_BATCH");
+            return -1;
+        }
+        if (step == steps)
+            break; // 最后一帧之后不需要等待
+
+        next.tv_nsec += TRANSITION_FRAME_NS;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return 0;
+}
+
+/* 轮播的调度项编号，-1 表示不轮播 */
+static int carousel_id = -1;
+
+/**
+ * @Description: 切换界面：先更新新界面的内容并切换调度的数据项，再播放切换动画
+ * @param {int} page: 新界面
+ * @return {*} 出错时返回 -1
+ */
+static int switch_page(int page) {
+    display_schedule(page);
+    if (run_transition(config.page, page) < 0)
+        return -1;
+    config.page = page;
+    return 0;
+}
+
+/**
+ * @Description: 轮播调度项：切换到下一个界面
+ * @param {void} *arg: 未使用
+ * @return {*} 1 需要绘制，-1 出错
+ */
+static int carousel_step(void *arg) {
+    (void)arg;
+    if (switch_page(config.page % PAGE_COUNT + 1) < 0)
+        return -1;
+    return 1;
+}
+
+/*********************************** 定时 *********************************/
+/* 主循环统计 */
+typedef struct {
+    unsigned long frames;       // 处理的帧数
+    unsigned long idle;         // 内容没有变化、不需要发送的帧数
+    long long render_ns, render_max_ns;     // 绘制耗时
+    long long refresh_ns, refresh_max_ns;   // 发送耗时
+} LoopStats;
+
+static LoopStats loop_stats;
+
+/**
+ * @Description: 两个时间点之间的纳秒数
+ * @return {*}
+ */
+static long long elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1000000000LL + (b->tv_nsec - a->tv_nsec);
+}
+
+/**
+ * @Description: 打印主循环统计
+ * @return {*}
+ */
+static void print_loop_stats(void) {
+    LoopStats *s = &loop_stats;
+    unsigned long sent = s->frames - s->idle;
+
+    sched_print_stats();
+    if (s->frames == 0)
+        return;
+    printf("Frames: %lu (idle %lu)\n", s->frames, s->idle);
+    printf("Render: avg %lld us, max %lld us; Refresh: avg %lld us, max %lld us\n",
+           s->render_ns / (long long)s->frames / 1000, s->render_max_ns / 1000,
+           sent ? s->refresh_ns / (long long)sent / 1000 : 0, s->refresh_max_ns / 1000);
+}
+
+/**
+ * @Description: 把定时器设置为调度器下一次需要醒来的时间（单次，墙上时钟的绝对时间），
+ *               没有调度项时停止定时器；系统时间被修改时 read 返回 ECANCELED，需要重新计时
+ * @param {int} tfd: timerfd
+ * @return {*} 0 成功，-1 失败
+ */
+static int loop_timer_arm(int tfd) {
+    struct itimerspec its = { 0 };
+    long long next = sched_next();
+
+    if (next >= 0) {
+        its.it_value.tv_sec = next / 1000000000LL;
+        its.it_value.tv_nsec = next % 1000000000LL;
+    }
+    return timerfd_settime(tfd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &its, NULL);
+}
+
+/**
+ * @Description: 把文件描述符加入主循环的 epoll（可读时唤醒）
+ * @param {int} epfd: epoll
+ * @param {int} efd: 文件描述符
+ * @return {*} 0 成功，-1 失败
+ */
+static int loop_watch(int epfd, int efd) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = efd };
+
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, efd, &ev);
+}
+
+/*********************************** 视频输入 *********************************/
+/**
+ * @Description: 打印视频输入的统计：收到（发送方提供）的帧率和实际显示的帧率
+ * @param {const IngestReader} *in: 读取器
+ * @param {unsigned long} shown: 已显示的帧数
+ * @param {double} seconds: 统计时长
+ * @return {*}
+ */
+static void print_ingest_stats(const IngestReader *in, unsigned long shown, double seconds) {
+    if (seconds <= 0)
+        return;
+    fprintf(stderr, "%lu frames offered, %lu shown, %lu dropped in %.1f s: offered %.1f fps, achieved %.1f fps\n",
+            in->received, shown, in->dropped, seconds, in->received / seconds, shown / seconds);
+}
+
+/**
+ * @Description: 从标准输入读取原始帧并显示，按屏幕能达到的最快速度刷新
+ *               显示一帧期间到达的帧只保留最新的一帧，其余丢弃；管道写满后发送方被阻塞
+ * @param {int} format: 像素格式 PixFormat
+ * @return {*} 出错时返回 -1
+ */
+static int play_stdin(int format) {
+    IngestReader in;
+    PixConfig cfg = { .dither = PIX_ORDERED, .threshold = 127 }; // 有序抖动有 SIMD 实现，帧间也不会闪烁
+    uint8_t frame[FRAME_BUFFER_SIZE];
+    Rect damage[MAX_DAMAGE];
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+    struct timespec start, report, now;
+    unsigned long shown = 0, report_received = 0, report_shown = 0;
+    int count, ret = 0;
+
+    if (ingest_open(&in, STDIN_FILENO, format) < 0)
+        return -1;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    report = start;
+    while (!in.eof || in.pending) {
+        // 没有待显示的帧时等待输入，每秒至少醒来一次输出统计
+        if (!in.pending && poll(&pfd, 1, 1000) < 0 && errno != EINTR) {
+            perror("poll");
+            ret = -1;
+            break;
+        }
+        if (ingest_read(&in) < 0) {
+            ret = -1;
+            break;
+        }
+
+        if (in.pending) {
+            Surface fb, view;
+
+            in.pending = 0;
+            pixconv_image(in.latest, in.stride, format, frame, NULL, &cfg);
+            surface_init(&fb, (uint8_t *)oled_framebuffer, FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH);
+            surface_init(&view, frame, FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH);
+            count = surface_publish(&fb, &view, damage, MAX_DAMAGE);
+            // 阻塞到发送完成，期间到达的帧留在管道中
+            if (count > 0 && oled_flush_damage(damage, count) < 0) {
+                perror("ioctl failed: IOCTL_OLED_BATCH");
+                ret = -1;
+                break;
+            }
+            shown++;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (config.verbose && elapsed_ns(&report, &now) >= 1000000000LL) {
+            double seconds = elapsed_ns(&report, &now) / 1e9;
+
+            fprintf(stderr, "offered %.1f fps, achieved %.1f fps, dropped %lu\n",
+                    (in.received - report_received) / seconds, (shown - report_shown) / seconds, in.dropped);
+            report = now;
+            report_received = in.received;
+            report_shown = shown;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    print_ingest_stats(&in, shown, elapsed_ns(&start, &now) / 1e9);
+    ingest_close(&in);
+    return ret;
+}
+
+/*********************************** 界面 *********************************/
+/**
+ * @Description: 绘制当前界面的一帧，只刷新变化的区域
+ * @return {*} 0 成功，-1 刷新失败
+ */
+static int render_frame(void) {
+    Rect damage[MAX_DAMAGE];
+    struct timespec t0, t1, t2;
+    int count;
+
+    // 只操作 oled_framebuffer 的前 1024 字节，只重绘变化的控件
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (config.server) {
+        // 显示服务：界面作为最底层，与其他进程的图层一起合成
+        const uint8_t *base = display_frame(config.page, damage, MAX_DAMAGE, &count);
+
+        count = base ? server_compose(base, damage, count, (uint8_t *)oled_framebuffer, damage, MAX_DAMAGE) : 0;
+    } else {
+        count = display_ui(config.page, oled_framebuffer, FRAME_BUFFER_SIZE, damage, MAX_DAMAGE);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    loop_stats.frames++;
+    loop_stats.render_ns += elapsed_ns(&t0, &t1);
+    if (elapsed_ns(&t0, &t1) > loop_stats.render_max_ns)
+        loop_stats.render_max_ns = elapsed_ns(&t0, &t1);
+    if (count == 0) {
+        loop_stats.idle++;
+        return 0; // 内容没变，不用发送
+    }
+
+    /* 只刷新变化的区域 */
+    if (oled_flush_damage(damage, count) < 0) {
+        perror("ioctl failed: IOCTL_OLED_BATCH");
+        return -1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    loop_stats.refresh_ns += elapsed_ns(&t1, &t2);
+    if (elapsed_ns(&t1, &t2) > loop_stats.refresh_max_ns)
+        loop_stats.refresh_max_ns = elapsed_ns(&t1, &t2);
+    return 0;
+}
+
+/**
+ * @Description: 执行控制 socket 收到的命令，下一帧生效，不重新初始化屏幕
+ * @param {const ControlCmd} *cmd: 命令
+ * @param {int} afd: 提示定时器
+ * @return {*} 0 成功，-1 切换动画刷新失败
+ */
+static int apply_command(const ControlCmd *cmd, int afd) {
+    static char text[CONTROL_TEXT_MAX];
+    struct itimerspec its = { 0 };
+
+    switch (cmd->type) {
+        case CONTROL_PAGE:
+            if (cmd->value != config.page && switch_page(cmd->value) < 0)
+                return -1;
+            sched_enable(carousel_id, 1); // 轮播从新界面重新计时
+            break;
+        case CONTROL_TEXT:
+            snprintf(text, sizeof(text), "%s", cmd->text);
+            config.text = text;
+            display_set_text(config.text);
+            break;
+        case CONTROL_INTERVAL:
+            config.interval = cmd->value;
+            sched_set_min_period(config.interval);
+            break;
+        case CONTROL_ALERT:
+            // 提示定时器到期时关闭提示框，0 秒表示立即关闭
+            display_set_alert(cmd->value ? (cmd->text[0] ? cmd->text : "ALERT") : NULL);
+            its.it_value.tv_sec = cmd->value;
+            timerfd_settime(afd, 0, &its, NULL);
+            break;
+    }
+    if (config.verbose)
+        printf("Control: type %d, value %d, text \"%s\"\n", cmd->type, cmd->value, cmd->text);
+    return 0;
+}
 
 /*********************************** 信号处理 *********************************/
 /**
@@ -39,6 +431,9 @@ void handle_signal(int signum) {
         printf("Caught SIGTERM!");
     }
     printf("\tCleaning up...\n");
+    if (config.verbose) {
+        print_loop_stats();
+    }
     if (oled_framebuffer) {
         munmap(oled_framebuffer, buffer_size);
     }
@@ -63,22 +458,16 @@ int main(int argc, char *argv[]) {
     /* 解析命令行参数 */ 
     config = parse_arguments(argc, argv);
 
-    /* 检查是否传入 GPIO */
-    if (config.oled_pins == NULL) {
-        printf("\n****** Need oled_pins! Please retry! ******\n\n");
-        print_help(argv[0]);
-        exit(EXIT_FAILURE);
-    }
-
     /* 打印配置信息 */ 
     if (config.verbose) {
         print_config(config);
     }
 
     /* 解析 GPIO */ 
-    char *token = strtok(config.oled_pins, ",");
+    // 未传入 GPIO 时直接接管由设备树/模块参数初始化好的屏幕
     int gpio_num = 0;
     int oled_gpios[PIN_NUM];
+    char *token = config.oled_pins ? strtok(config.oled_pins, ",") : NULL;
     while (token) {
         if (gpio_num >= PIN_NUM) {
             fprintf(stderr, "Error: Too many ports specified (max %d).\n", PIN_NUM);
@@ -88,6 +477,22 @@ int main(int argc, char *argv[]) {
         // 传入 NULL 表示继续从上次的位置查找下一个子字符串
         token = strtok(NULL, ",");
     }
+    if (config.oled_pins && gpio_num != PIN_NUM) {
+        printf("\n****** Need %d oled_pins! Please retry! ******\n\n", PIN_NUM);
+        print_help(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    /* 加载外部字库，只映射不读入，用到的字才会被读进内存 */
+    if (config.font) {
+        if (font_open(&font, config.font) < 0)
+            return 1;
+        OLED_SetFont(&font);
+    }
+
+    /* 打开硬件状态文件，由后台线程按各自的周期采样，渲染循环只读取最新值 */
+    if (sampler_init() == 0)
+        sampler_start();
 
     /**************** oled 设备配置 *****************/
     /* 打开设备 */
@@ -104,19 +509,33 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    /* 使用 ioctl 传递 GPIO */
-    struct oled_gpio_stuct gpio_group = {
-        .scl_pin = oled_gpios[0],
-        .mosi_pin = oled_gpios[1],
-        .res_pin = oled_gpios[2],
-        .dc_pin = oled_gpios[3]
-    };
-    ret = ioctl(fd, IOCTL_OLED_SET_GPIO, &gpio_group);
-    if (ret < 0) {
-        perror("ioctl failed: IOCTL_OLED_SET_GPIO");
-        flock(fd, LOCK_UN);
-        close(fd);
-        return ret;
+    /* 使用 ioctl 传递 GPIO，屏幕已初始化时驱动不会再次复位 */
+    if (config.oled_pins) {
+        struct oled_gpio_stuct gpio_group = {
+            .scl_pin = oled_gpios[0],
+            .mosi_pin = oled_gpios[1],
+            .res_pin = oled_gpios[2],
+            .dc_pin = oled_gpios[3]
+        };
+        ret = ioctl(fd, IOCTL_OLED_SET_GPIO, &gpio_group);
+        if (ret < 0) {
+            perror("ioctl failed: IOCTL_OLED_SET_GPIO");
+            flock(fd, LOCK_UN);
+            close(fd);
+            return ret;
+        }
+    }
+
+    /* 显示方向：0/180 度与镜像由控制器完成，90/270 度在竖屏画布中绘制后转置 */
+    if (config.rotate || config.flip) {
+        __u32 orientation = config.flip;
+
+        if (config.rotate == 180)
+            orientation ^= OLED_ORIENT_ROTATE_180;
+        if (orientation && ioctl(fd, IOCTL_OLED_SET_ORIENTATION, &orientation) < 0)
+            perror("ioctl failed: IOCTL_OLED_SET_ORIENTATION");
+        if (config.rotate != 180)
+            OLED_SetRotation(config.rotate);
     }
 
     /**************** 内存映射 *****************/
@@ -140,29 +559,153 @@ int main(int argc, char *argv[]) {
         return ret;
     }
 
+    /* 播放动画或标准输入的视频，不显示界面 */
+    if (config.anim)
+        ret = play_animation(config.anim);
+    else if (config.stdin_format >= 0)
+        ret = play_stdin(config.stdin_format);
+
+    /* 调度定时器、提示定时器、信号、控制 socket 和显示服务都在同一个 epoll 中等待，休眠时不占用 CPU */
+    int epfd = -1, tfd = -1, afd = -1, sfd = -1, running = 0;
+    display_set_text(config.text);
+    if (!config.anim && config.stdin_format < 0) {
+        sigset_t mask;
+
+        // 各数据项按自己的周期更新，定时器只在最早到期的项需要运行时唤醒
+        display_schedule(config.page);
+        sched_set_min_period(config.interval);
+        if (config.carousel)
+            carousel_id = sched_add("carousel", config.carousel * 1000,
+                                    config.transition == TRANSITION_NONE ? 1000 :
+                                    TRANSITION_STEPS * (TRANSITION_FRAME_NS / 1000), 0, carousel_step, NULL);
+
+        // SIGINT/SIGTERM 改为从 signalfd 读取，退出主循环后正常清理
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGINT);
+        sigaddset(&mask, SIGTERM);
+        sigprocmask(SIG_BLOCK, &mask, NULL);
+
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        tfd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC);
+        afd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        sfd = signalfd(-1, &mask, SFD_CLOEXEC);
+        if (epfd < 0 || tfd < 0 || afd < 0 || sfd < 0 || loop_timer_arm(tfd) < 0 ||
+            loop_watch(epfd, tfd) < 0 || loop_watch(epfd, afd) < 0 || loop_watch(epfd, sfd) < 0) {
+            perror("main loop");
+            ret = -1;
+        } else {
+            running = 1;
+            if (control_open(config.socket, epfd) < 0)
+                fprintf(stderr, "Control socket disabled.\n");
+            if (config.server && server_open(SERVER_SOCKET_PATH, epfd) < 0)
+                fprintf(stderr, "Display server disabled.\n");
+            // 立即显示第一帧，不等第一个周期
+            if (render_frame() < 0) {
+                ret = -1;
+                running = 0;
+            }
+        }
+    }
+
     // 主循环
-    while (1) {
-        int ret;
-        /* 阻塞等待超时 */ 
-        ret = poll(NULL, 0, config.interval);  // 使用 poll 实现定时器，并且休眠时不占用 CPU
-        if (ret != 0) {
-            perror("poll");
+    while (running) {
+        struct epoll_event events[8];
+        int n = epoll_wait(epfd, events, 8, -1);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("epoll_wait");
+            ret = -1;
             break;
         }
+        for (int i = 0; i < n && running; i++) {
+            int efd = events[i].data.fd, r;
+            uint64_t expirations;
 
-        /* 设置帧缓冲数据 */
-        // 只操作 oled_framebuffer 的前 1024 字节
-        display_ui(config.page, oled_framebuffer, FRAME_BUFFER_SIZE);
+            if (efd == sfd) {
+                /* 退出信号 */
+                struct signalfd_siginfo si;
 
-        /* 刷新 oled */ 
-        ret = ioctl(fd, IOCTL_OLED_REFRESH, &gpio_group);
-        if (ret < 0) {
-            perror("ioctl failed: IOCTL_OLED_REFRESH");
+                if (read(sfd, &si, sizeof(si)) == sizeof(si))
+                    printf("\nCaught %s!\tCleaning up...\n", si.ssi_signo == SIGINT ? "SIGINT" : "SIGTERM");
+                running = 0;
+            } else if (efd == afd) {
+                /* 提示到时间，关闭提示框 */
+                if (read(afd, &expirations, sizeof(expirations)) < 0)
+                    continue;
+                display_set_alert(NULL);
+                if (render_frame() < 0) {
+                    ret = -1;
+                    running = 0;
+                }
+            } else if (efd == tfd) {
+                /* 有数据项到期，只有可见内容变化时才绘制 */
+                if (read(tfd, &expirations, sizeof(expirations)) < 0) {
+                    if (errno == ECANCELED) {
+                        // 系统时间被修改，重新计时
+                        sched_reset();
+                        continue;
+                    }
+                    if (errno == EINTR || errno == EAGAIN)
+                        continue;
+                    perror("read timerfd");
+                    ret = -1;
+                    running = 0;
+                    break;
+                }
+                r = sched_run();
+                if (r < 0 || (r > 0 && render_frame() < 0)) {
+                    ret = -1;
+                    running = 0;
+                }
+            } else if ((r = server_handle(epfd, efd)) >= 0) {
+                /* 显示服务的客户端申请区域、提交脏矩形或断开，立即合成一帧 */
+                if (r > 0 && render_frame() < 0) {
+                    ret = -1;
+                    running = 0;
+                }
+            } else {
+                /* 控制命令，执行后立即绘制一帧 */
+                ControlCmd cmds[CONTROL_MAX_CMDS];
+                int count = control_handle(epfd, efd, cmds, CONTROL_MAX_CMDS);
+
+                for (int c = 0; c < count && running; c++) {
+                    if (apply_command(&cmds[c], afd) < 0) {
+                        ret = -1;
+                        running = 0;
+                    }
+                }
+                if (running && count > 0 && render_frame() < 0) {
+                    ret = -1;
+                    running = 0;
+                }
+            }
+        }
+        // 命令可能修改了周期或切换了界面，按最早到期的项重新设置定时器
+        if (running && loop_timer_arm(tfd) < 0) {
+            perror("timerfd_settime");
+            ret = -1;
             break;
         }
     }
     
+    server_close();
+    control_close();
+    if (sfd >= 0)
+        close(sfd);
+    if (afd >= 0)
+        close(afd);
+    if (epfd >= 0)
+        close(epfd);
+    if (tfd >= 0)
+        close(tfd);
+    if (config.verbose)
+        print_loop_stats();
     munmap(oled_framebuffer, buffer_size);
+    font_close(&font);
+    sampler_stop();
+    sampler_close();
     flock(fd, LOCK_UN);
     close(fd);
     return ret;
@@ -24,6 +24,8 @@ pin_str="$scl_pin,$mosi_pin,$res_pin,$dc_pin"
 
 # PID 文件路径
 PID_FILE="${script_path}/spi_oled_app.pid"
+# 控制 socket（CONTROL_SOCKET_PATH），app 打开设备、进入主循环后才创建，用来判断启动完成
+SOCKET_PATH="/tmp/spi_oled_app.sock"
 
 # 检查 PID 文件是否存在
 if [ -f "$PID_FILE" ]; then
@@ -31,16 +33,32 @@ if [ -f "$PID_FILE" ]; then
     exit 1
 fi
 
-sleep 2
+# 驱动在加载时（设备树、gpios= 模块参数或 I2C 绑定）已经初始化屏幕时，
+# app 直接接管正在显示的屏幕，不传引脚，也不等待复位
+# 以驱动导出的 panel_ready 为准：参数给出的引脚申请失败时屏幕并不存在
+panel_configured() {
+    [ "$(cat /sys/class/spi_oled/spi_oled/panel_ready 2>/dev/null)" = "1" ]
+}
+
+# 清除上次异常退出留下的 socket，避免误判为已启动
+rm -f "$SOCKET_PATH"
 
 # 后台执行脚本
-${script_path}/spi_oled_app -p 2 -o "$pin_str" &
+if panel_configured; then
+    ${script_path}/spi_oled_app -p 2 &
+else
+    ${script_path}/spi_oled_app -p 2 -o "$pin_str" &
+fi
 
 # 获取后台进程的 PID
 APP_PID=$!
 
-# 等待程序运行一段时间，确保程序启动
-sleep 1
+# 等待控制 socket 出现（最多 3 秒），进程提前退出（引脚错误、设备被占用）时立即结束等待
+for i in $(seq 30); do
+    [ -S "$SOCKET_PATH" ] && break
+    kill -0 "$APP_PID" > /dev/null 2>&1 || break
+    sleep 0.1
+done
 
 # 检查进程是否仍在运行
 if kill -0 "$APP_PID" > /dev/null 2>&1; then
@@ -0,0 +1,193 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 18:05:44
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 18:05:44
+ * @Description: 动画容器（.ola），mmap 加载，关键帧直接复制，差分帧按 XOR 游程解码到帧缓冲
+ *               播放过的部分及时释放映射，长动画也只占用很少的内存
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "anim.h"
+
+/* 已播放的数据超过这个大小时释放映射 */
+#define ANIM_RELEASE_CHUNK (256 * 1024)
+
+/**
+ * @Description: 打开并映射动画文件
+ * @param {AnimPlayer} *anim: 输出播放器
+ * @param {const char} *path: 动画文件路径
+ * @return {*} 0 成功，-1 失败
+ */
+int anim_open(AnimPlayer *anim, const char *path) {
+    const OlaHeader *hdr;
+    const OlaFrame *first;
+    struct stat st;
+    void *base;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open animation");
+        return -1;
+    }
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(OlaHeader)) {
+        fprintf(stderr, "%s: not an animation file\n", path);
+        close(fd);
+        return -1;
+    }
+
+    base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("Failed to mmap animation");
+        return -1;
+    }
+    // 按顺序播放，让内核提前预读后面的帧
+    madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+    hdr = base;
+    first = NULL;
+    if (hdr->magic == OLA_MAGIC && hdr->version == OLA_VERSION && hdr->count > 0 &&
+        hdr->index_offset <= st.st_size &&
+        hdr->count <= (st.st_size - hdr->index_offset) / sizeof(OlaFrame))
+        first = (const OlaFrame *)((const uint8_t *)base + hdr->index_offset);
+    // 第一帧必须是关键帧
+    if (!first || first->type != OLA_FRAME_RAW || first->size != FRAME_BUFFER_SIZE) {
+        fprintf(stderr, "%s: bad animation header (version %d, need %d)\n", path, hdr->version, OLA_VERSION);
+        munmap(base, st.st_size);
+        return -1;
+    }
+
+    anim->base = base;
+    anim->size = st.st_size;
+    anim->header = hdr;
+    anim->frames = first;
+    anim->next = 0;
+    anim->released = 0;
+    return 0;
+}
+
+/**
+ * @Description: 解除动画映射
+ * @param {AnimPlayer} *anim: 播放器
+ * @return {*}
+ */
+void anim_close(AnimPlayer *anim) {
+    if (anim->base)
+        munmap((void *)anim->base, anim->size);
+    anim->base = NULL;
+}
+
+/**
+ * @Description: 回到第一帧（帧缓冲被其他内容覆盖后，差分帧需要从关键帧重新开始）
+ * @param {AnimPlayer} *anim: 播放器
+ * @return {*}
+ */
+void anim_rewind(AnimPlayer *anim) {
+    anim->next = 0;
+}
+
+/**
+ * @Description: 释放已经播放过的映射，文件页仍在页缓存中，再次访问时重新映射
+ * @param {AnimPlayer} *anim: 播放器
+ * @param {size_t} offset: 当前播放到的文件偏移
+ * @return {*}
+ */
+static void anim_release(AnimPlayer *anim, size_t offset) {
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t end = offset & ~(page - 1);
+
+    if (end < anim->released) // 循环播放回到开头
+        anim->released = 0;
+    if (end - anim->released < ANIM_RELEASE_CHUNK)
+        return;
+    // 文件头和帧索引所在的页一直需要，从它们之后开始释放
+    if (anim->released == 0)
+        anim->released = (anim->header->index_offset + anim->header->count * sizeof(OlaFrame) + page - 1) & ~(page - 1);
+    if (end > anim->released)
+        madvise((void *)(anim->base + anim->released), end - anim->released, MADV_DONTNEED);
+    anim->released = end;
+}
+
+/**
+ * @Description: 解码 XOR 差分帧，记录每页变化的列范围
+ * @param {uint8_t} *fb: 帧缓冲（内容为上一帧）
+ * @param {const uint8_t} *p: 差分数据
+ * @param {uint32_t} size: 差分数据大小
+ * @param {short} *x0: 每页变化的起始列
+ * @param {short} *x1: 每页变化的结束列，-1 表示该页没有变化
+ * @return {*} 0 成功，-1 数据越界
+ */
+static int apply_delta(uint8_t *fb, const uint8_t *p, uint32_t size, short *x0, short *x1) {
+    const uint8_t *end = p + size;
+    int pos = 0;
+
+    while (end - p >= 2) {
+        int skip = p[0], len = p[1];
+        p += 2;
+        pos += skip;
+        if (len == 0)
+            continue;
+        if (pos + len > FRAME_BUFFER_SIZE || end - p < len)
+            return -1;
+
+        // 一条记录可能跨页，分页记录变化的列
+        for (int i = pos; i < pos + len; ) {
+            int page = i / FRAME_WIDTH;
+            int stop = (page + 1) * FRAME_WIDTH < pos + len ? (page + 1) * FRAME_WIDTH : pos + len;
+            if (x1[page] < 0 || i % FRAME_WIDTH < x0[page])
+                x0[page] = i % FRAME_WIDTH;
+            if ((stop - 1) % FRAME_WIDTH > x1[page])
+                x1[page] = (stop - 1) % FRAME_WIDTH;
+            i = stop;
+        }
+        for (int i = 0; i < len; i++)
+            fb[pos + i] ^= p[i];
+        p += len;
+        pos += len;
+    }
+    return 0;
+}
+
+/**
+ * @Description: 把下一帧写入帧缓冲
+ * @param {AnimPlayer} *anim: 播放器
+ * @param {uint8_t} *frame_buffer: 帧缓冲
+ * @param {Rect} *damage: 输出变化的区域
+ * @param {int} max_damage: 脏矩形数组大小，不够时合并到最后一个
+ * @param {uint32_t} *duration_ms: 输出这一帧的显示时长
+ * @return {*} 脏矩形个数，-1 表示帧数据损坏
+ */
+int anim_next(AnimPlayer *anim, uint8_t *frame_buffer, Rect *damage, int max_damage, uint32_t *duration_ms) {
+    const OlaFrame *f = &anim->frames[anim->next];
+    short x0[FRAME_HEIGHT / 8], x1[FRAME_HEIGHT / 8];
+
+    if (f->offset > anim->size || f->size > anim->size - f->offset)
+        return -1;
+
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++)
+        x1[p] = -1;
+    if (f->type == OLA_FRAME_RAW) {
+        if (f->size != FRAME_BUFFER_SIZE)
+            return -1;
+        memcpy(frame_buffer, anim->base + f->offset, FRAME_BUFFER_SIZE);
+        for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+            x0[p] = 0;
+            x1[p] = FRAME_WIDTH - 1;
+        }
+    } else if (f->type != OLA_FRAME_DELTA ||
+               apply_delta(frame_buffer, anim->base + f->offset, f->size, x0, x1) < 0) {
+        return -1;
+    }
+
+    *duration_ms = f->duration_ms;
+    anim_release(anim, f->offset);
+    anim->next = (anim->next + 1) % anim->header->count;
+    return OLED_PageDamage(x0, x1, damage, max_damage);
+}
@@ -0,0 +1,253 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 21:48:25
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 21:48:25
+ * @Description: 本地控制 socket，监听和客户端连接都注册在主循环的 epoll 中，不另开线程
+ *               这里只解析和校验命令，由主循环在下一帧之前执行
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#define _GNU_SOURCE // accept4
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+
+#include "control.h"
+#include "page.h"
+
+/* 同时连接的客户端个数 */
+#define CONTROL_MAX_CLIENTS 4
+
+/* 客户端连接，收到的数据按行切分 */
+typedef struct {
+    int fd;                 // -1 表示空闲
+    int len;                // 缓冲中未处理的字节数
+    char buf[CONTROL_LINE_MAX];
+} Client;
+
+static int listen_fd = -1;
+static char socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static Client clients[CONTROL_MAX_CLIENTS];
+
+static const char help_text[] =
+    "page <1-3>\n"
+    "text <string>\n"
+    "interval <ms>\n"
+    "alert <seconds> [message]\n";
+
+/**
+ * @Description: 监听控制 socket，并加入主循环的 epoll
+ * @param {const char} *path: socket 路径
+ * @param {int} epfd: 主循环的 epoll
+ * @return {*} 0 成功，-1 失败
+ */
+int control_open(const char *path, int epfd) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    struct epoll_event ev = { .events = EPOLLIN };
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Control socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    // 设备已被 flock 独占，残留的 socket 文件只可能来自上次异常退出
+    unlink(path);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, CONTROL_MAX_CLIENTS) < 0) {
+        perror(path);
+        close(listen_fd);
+        listen_fd = -1;
+        return -1;
+    }
+    chmod(path, 0600); // 只允许同一用户控制屏幕
+    strcpy(socket_path, path);
+
+    for (int i = 0; i < CONTROL_MAX_CLIENTS; i++)
+        clients[i].fd = -1;
+    ev.data.fd = listen_fd;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, listen_fd, &ev) < 0) {
+        perror("epoll_ctl");
+        control_close();
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @Description: 关闭所有连接并删除 socket 文件
+ * @return {*}
+ */
+void control_close(void) {
+    if (listen_fd < 0)
+        return;
+    for (int i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0)
+            close(clients[i].fd);
+        clients[i].fd = -1;
+    }
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(socket_path);
+}
+
+/**
+ * @Description: 回复客户端，socket 非阻塞，对方不读时丢弃回复，不阻塞主循环
+ * @param {int} fd: 客户端
+ * @param {const char} *msg: 回复内容
+ * @return {*}
+ */
+static void client_reply(int fd, const char *msg) {
+    if (send(fd, msg, strlen(msg), MSG_NOSIGNAL | MSG_DONTWAIT) < 0 && errno != EAGAIN)
+        perror("control reply");
+}
+
+/**
+ * @Description: 解析一行命令
+ * @param {char} *line: 命令（会被修改）
+ * @param {ControlCmd} *cmd: 输出解析结果
+ * @param {int} *is_cmd: 输出是否需要主循环执行（help 等直接回复的命令为 0）
+ * @return {*} 回复内容
+ */
+static const char *parse_command(char *line, ControlCmd *cmd, int *is_cmd) {
+    char *arg, *end;
+    long v;
+
+    *is_cmd = 0;
+    while (isspace((unsigned char)*line))
+        line++;
+    if (*line == '\0')
+        return "";
+
+    // 命令和参数用空白分开，参数保留中间的空格
+    arg = line + strcspn(line, " \t");
+    if (*arg)
+        *arg++ = '\0';
+    while (isspace((unsigned char)*arg))
+        arg++;
+
+    memset(cmd, 0, sizeof(*cmd));
+    if (strcmp(line, "help") == 0)
+        return help_text;
+    if (strcmp(line, "text") == 0) {
+        cmd->type = CONTROL_TEXT;
+        snprintf(cmd->text, sizeof(cmd->text), "%s", arg);
+        *is_cmd = 1;
+        return "ok\n";
+    }
+
+    if (strcmp(line, "page") == 0)
+        cmd->type = CONTROL_PAGE;
+    else if (strcmp(line, "interval") == 0)
+        cmd->type = CONTROL_INTERVAL;
+    else if (strcmp(line, "alert") == 0)
+        cmd->type = CONTROL_ALERT;
+    else
+        return "error: unknown command (try help)\n";
+
+    v = strtol(arg, &end, 10);
+    if (end == arg)
+        return "error: missing number\n";
+    while (isspace((unsigned char)*end))
+        end++;
+    if (cmd->type == CONTROL_PAGE && (v < 1 || v > PAGE_COUNT || *end))
+        return "error: page must be 1, 2 or 3\n";
+    if (cmd->type == CONTROL_INTERVAL && (v <= 0 || v > 3600000 || *end))
+        return "error: interval must be 1~3600000 ms\n";
+    if (cmd->type == CONTROL_ALERT) {
+        if (v < 0 || v > 86400)
+            return "error: alert duration must be 0~86400 s\n";
+        snprintf(cmd->text, sizeof(cmd->text), "%s", end);
+    }
+    cmd->value = v;
+    *is_cmd = 1;
+    return "ok\n";
+}
+
+/**
+ * @Description: 处理控制 socket 上的事件：接受新连接，或读取客户端的命令
+ * @param {int} epfd: 主循环的 epoll
+ * @param {int} fd: 有事件的文件描述符
+ * @param {ControlCmd} *cmds: 输出解析出的命令
+ * @param {int} max_cmds: 命令数组大小
+ * @return {*} 解析出的命令个数
+ */
+int control_handle(int epfd, int fd, ControlCmd *cmds, int max_cmds) {
+    Client *cl = NULL;
+    int count = 0;
+    ssize_t n;
+    char *nl;
+
+    if (fd == listen_fd) {
+        int c;
+
+        while ((c = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+            struct epoll_event ev = { .events = EPOLLIN, .data.fd = c };
+
+            for (int i = 0; i < CONTROL_MAX_CLIENTS && !cl; i++)
+                if (clients[i].fd < 0)
+                    cl = &clients[i];
+            if (!cl || epoll_ctl(epfd, EPOLL_CTL_ADD, c, &ev) < 0) {
+                client_reply(c, "error: too many clients\n");
+                close(c);
+                continue;
+            }
+            cl->fd = c;
+            cl->len = 0;
+            cl = NULL;
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < CONTROL_MAX_CLIENTS && !cl; i++)
+        if (clients[i].fd == fd)
+            cl = &clients[i];
+    if (!cl)
+        return 0;
+
+    n = read(fd, cl->buf + cl->len, sizeof(cl->buf) - 1 - cl->len);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+        return 0;
+    if (n <= 0) {
+        close(fd); // 关闭时自动从 epoll 中移除
+        cl->fd = -1;
+        return 0;
+    }
+    cl->len += n;
+    cl->buf[cl->len] = '\0';
+
+    while ((nl = strchr(cl->buf, '\n'))) {
+        const char *reply;
+        int is_cmd;
+
+        *nl = '\0';
+        if (nl > cl->buf && nl[-1] == '\r')
+            nl[-1] = '\0';
+        if (count < max_cmds) {
+            reply = parse_command(cl->buf, &cmds[count], &is_cmd);
+            count += is_cmd;
+        } else {
+            reply = "error: busy\n";
+        }
+        client_reply(fd, reply);
+        cl->len -= nl + 1 - cl->buf;
+        memmove(cl->buf, nl + 1, cl->len + 1);
+    }
+    if (cl->len == (int)sizeof(cl->buf) - 1) {
+        client_reply(fd, "error: line too long\n");
+        cl->len = 0;
+    }
+    return count;
+}
@@ -0,0 +1,143 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 15:20:47
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 15:20:47
+ * @Description: 外部点阵字库（.olf），mmap 加载，按码位二分查找
+ *               只有查找时访问到的索引页和显示过的字模页才会被读入内存
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "font.h"
+
+/**
+ * @Description: 打开并映射字库文件
+ * @param {OlfFont} *font: 输出已加载的字库
+ * @param {const char} *path: 字库文件路径
+ * @return {*} 0 成功，-1 失败
+ */
+int font_open(OlfFont *font, const char *path) {
+    const OlfHeader *hdr;
+    struct stat st;
+    void *base;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open font");
+        return -1;
+    }
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(OlfHeader)) {
+        fprintf(stderr, "%s: not a font file\n", path);
+        close(fd);
+        return -1;
+    }
+
+    base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // 映射建立后可以关闭文件
+    if (base == MAP_FAILED) {
+        perror("Failed to mmap font");
+        return -1;
+    }
+    // 查找是随机访问，关闭预读，避免把整个字库读进来
+    madvise(base, st.st_size, MADV_RANDOM);
+
+    hdr = base;
+    if (hdr->magic != OLF_MAGIC || hdr->version != OLF_VERSION ||
+        hdr->pages != (hdr->height + 7) / 8 || hdr->height == 0 ||
+        hdr->index_offset > st.st_size ||
+        hdr->count > (st.st_size - hdr->index_offset) / sizeof(OlfGlyph) ||
+        hdr->data_offset > st.st_size) {
+        fprintf(stderr, "%s: bad font header (version %d, need %d)\n", path, hdr->version, OLF_VERSION);
+        munmap(base, st.st_size);
+        return -1;
+    }
+
+    font->base = base;
+    font->size = st.st_size;
+    font->header = hdr;
+    font->glyphs = (const OlfGlyph *)(font->base + hdr->index_offset);
+    font->data = font->base + hdr->data_offset;
+    return 0;
+}
+
+/**
+ * @Description: 解除字库映射
+ * @param {OlfFont} *font: 字库
+ * @return {*}
+ */
+void font_close(OlfFont *font) {
+    if (font->base)
+        munmap((void *)font->base, font->size);
+    font->base = NULL;
+}
+
+/**
+ * @Description: 二分查找字符
+ * @param {const OlfFont} *font: 字库
+ * @param {uint32_t} code: Unicode 码位
+ * @return {*} 索引项，字库中没有该字或字模越界时返回 NULL
+ */
+const OlfGlyph *font_find(const OlfFont *font, uint32_t code) {
+    const OlfGlyph *g;
+    uint32_t lo = 0, hi = font->header->count;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (font->glyphs[mid].code < code)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo >= font->header->count || font->glyphs[lo].code != code)
+        return NULL;
+
+    // 只在用到时检查字模是否在文件内，打开时不用遍历整个索引
+    g = &font->glyphs[lo];
+    if ((size_t)(font->data - font->base) + g->offset + (size_t)font->header->pages * g->width > font->size)
+        return NULL;
+    return g;
+}
+
+/**
+ * @Description: 解码一个 UTF-8 字符
+ * @param {const uint8_t} **p: 字符串位置，解码后指向下一个字符
+ * @return {*} Unicode 码位，非法编码返回 0xFFFD 并前进一个字节
+ */
+uint32_t utf8_next(const uint8_t **p) {
+    const uint8_t *s = *p;
+    uint32_t code;
+    int n;
+
+    if (s[0] < 0x80) {
+        *p = s + 1;
+        return s[0];
+    } else if ((s[0] & 0xE0) == 0xC0) {
+        code = s[0] & 0x1F;
+        n = 1;
+    } else if ((s[0] & 0xF0) == 0xE0) {
+        code = s[0] & 0x0F;
+        n = 2;
+    } else if ((s[0] & 0xF8) == 0xF0) {
+        code = s[0] & 0x07;
+        n = 3;
+    } else {
+        *p = s + 1;
+        return 0xFFFD;
+    }
+
+    for (int i = 1; i <= n; i++) {
+        if ((s[i] & 0xC0) != 0x80) { // 包括遇到结尾的 '\0'
+            *p = s + 1;
+            return 0xFFFD;
+        }
+        code = (code << 6) | (s[i] & 0x3F);
+    }
+    *p = s + n + 1;
+    return code;
+}
@@ -0,0 +1,119 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 23:02:37
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 23:02:37
+ * @Description: 原始视频输入，两个帧缓冲交替使用：一个接收，一个存放最新的完整帧，收满后交换指针
+ *               管道缓冲缩小到约两帧，屏幕跟不上时写入方很快被阻塞，延迟不会超过两帧
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#define _GNU_SOURCE // F_SETPIPE_SZ
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+
+#include "ingest.h"
+#include "pixconv.h"
+
+/**
+ * @Description: 初始化读取器，输入改为非阻塞
+ * @param {IngestReader} *in: 读取器
+ * @param {int} fd: 输入
+ * @param {int} format: 像素格式 PixFormat
+ * @return {*} 0 成功，-1 失败
+ */
+int ingest_open(IngestReader *in, int fd, int format) {
+    int flags = fcntl(fd, F_GETFL);
+    struct stat st;
+
+    *in = (IngestReader){ .fd = fd, .format = format };
+    in->file = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    in->stride = pixconv_row_bytes(format, FRAME_WIDTH);
+    in->frame_bytes = (size_t)in->stride * FRAME_HEIGHT;
+    in->buf = malloc(in->frame_bytes);
+    in->latest = malloc(in->frame_bytes);
+    if (!in->buf || !in->latest) {
+        perror("malloc");
+        ingest_close(in);
+        return -1;
+    }
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        perror("fcntl");
+        ingest_close(in);
+        return -1;
+    }
+    // 只对管道有效，输入是文件时忽略
+    fcntl(fd, F_SETPIPE_SZ, (int)in->frame_bytes * 2);
+    return 0;
+}
+
+/**
+ * @Description: 释放读取器，输入恢复为阻塞
+ * @param {IngestReader} *in: 读取器
+ * @return {*}
+ */
+void ingest_close(IngestReader *in) {
+    int flags = fcntl(in->fd, F_GETFL);
+
+    if (flags >= 0)
+        fcntl(in->fd, F_SETFL, flags & ~O_NONBLOCK);
+    free(in->buf);
+    free(in->latest);
+    in->buf = in->latest = NULL;
+}
+
+/**
+ * @Description: 读完调用时输入中已有的数据（普通文件只读一帧），最新的完整帧放在 latest 中
+ *               写入方一直写满管道时读取永远不会遇到 EAGAIN，所以只读进入时已有的字节数，之后返回去显示
+ * @param {IngestReader} *in: 读取器
+ * @return {*} 0 成功（包括没有数据和输入结束），-1 读取出错
+ */
+int ingest_read(IngestReader *in) {
+    int avail = 0;
+    size_t budget;
+
+    if (in->file && in->pending)
+        return 0;
+    // 查询失败或为 0（可能是输入结束）时最多读 INGEST_MAX_FRAMES 帧
+    if (ioctl(in->fd, FIONREAD, &avail) < 0 || avail <= 0)
+        budget = in->frame_bytes * INGEST_MAX_FRAMES;
+    else
+        budget = avail;
+    while (!in->eof && budget > 0) {
+        size_t want = in->frame_bytes - in->fill;
+        ssize_t n = read(in->fd, in->buf + in->fill, want < budget ? want : budget);
+        uint8_t *t;
+
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                return 0;
+            perror("read stdin");
+            return -1;
+        }
+        if (n == 0) {
+            in->eof = 1;    // 不完整的最后一帧丢弃
+            break;
+        }
+        in->fill += n;
+        budget -= n;
+        if (in->fill < in->frame_bytes)
+            continue;
+
+        // 收满一帧，成为最新的帧，上一帧还没显示就丢弃
+        t = in->latest;
+        in->latest = in->buf;
+        in->buf = t;
+        in->fill = 0;
+        in->dropped += in->pending;
+        in->pending = 1;
+        in->received++;
+        if (in->file)
+            break;
+    }
+    return 0;
+}
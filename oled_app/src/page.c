@@ -8,27 +8,40 @@
  * Copyright (c) 2025 Li RF, All Rights Reserved.
  */
 #include <time.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #include "page.h"
 #include "oledfont.h"
+#include "font_strips.h"
+#include "widget.h"
+#include "font.h"
+#include "sampler.h"
+#include "pixconv.h"
+#include "surface.h"
+#include "sched.h"
 
-static char *buffer; // 缓冲区
-static size_t size; // 缓冲区大小
+static int rotation;    // 软件旋转角度 0/90/270，界面在竖屏画布中绘制，再转置到帧缓冲
+static const OlfFont *ext_font; // 外部字库，显示非 ASCII 字符
 /***************************** 基础操作 ******************************/
 /**
  * @Description: 在OLED屏幕中绘制点
+ * @param {Surface} *s: 绘制目标
  * @param {uint8_t} x: x 坐标
  * @param {uint8_t} y: y 坐标
  * @param {uint8_t} point: 1 填充 0,清空
  * @return {*}
  */
-// oled 单字节的第一行是最高位，最后一行是最低位（0x80 绘制第一行）
-void OLED_DrawPoint(uint8_t x, uint8_t y, uint8_t point)
+// oled 单字节的第一行是最低位，最后一行是最高位（0x01 绘制第一行）
+void OLED_DrawPoint(Surface *s, uint8_t x, uint8_t y, uint8_t point)
 {
     uint8_t pos, bx, temp = 0;
     uint8_t *page_start;
     
-    if (x >= FRAME_WIDTH || y >= FRAME_HEIGHT)
+    if (x >= s->width || y >= s->height)
         return;
 
     // 计算页号（从上到下共 8 页）
@@ -38,10 +51,10 @@ void OLED_DrawPoint(uint8_t x, uint8_t y, uint8_t point)
     bx = y % 8;
     
     // 将该行对应的位设置为 1
-    temp = 1 << (7 - bx);
+    temp = 1 << bx;
 
     // 计算该页在缓冲区的起始位置
-    page_start = (uint8_t*)(buffer + pos * FRAME_WIDTH);
+    page_start = s->data + pos * s->stride;
 
     if (point)
         page_start[x] |= temp;
@@ -49,8 +62,95 @@ void OLED_DrawPoint(uint8_t x, uint8_t y, uint8_t point)
         page_start[x] &= ~temp;
 }
 
+/**
+ * @Description: 按字节列写入点阵，直接操作页字节，不逐点绘制
+ *               点阵每字节 8 行，最低位在上；整页对齐时直接复制，否则拆成相邻两页的移位/掩码写入
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x: 起始x坐标
+ * @param {int} y: 起始y坐标
+ * @param {const uint8_t} *src: 点阵数据
+ * @param {int} w: 点阵宽度（列数）
+ * @param {int} h: 点阵高度（行数）
+ * @param {int} col_stride: 相邻两列在 src 中的字节间隔（逐列式字模为每列字节数）
+ * @param {int} page_stride: 同一列上下相邻两字节在 src 中的间隔（逐列式字模为 1）
+ * @param {uint8_t} point: 1 正常显示 0 反色显示（背景同时写入）
+ * @return {*}
+ */
+void OLED_BlitColumns(Surface *s, int x, int y, const uint8_t *src, int w, int h,
+                      int col_stride, int page_stride, uint8_t point)
+{
+    int cols, rows, shift, page;
+    uint8_t mask, lo_mask, hi_mask, bits, invert;
+    uint8_t *dst, *dst2;
+    const uint8_t *sp;
+
+    // 整个点阵只裁剪一次
+    if (x < 0 || y < 0 || x >= s->width || y >= s->height || w <= 0 || h <= 0)
+        return;
+    cols = (x + w > s->width) ? s->width - x : w;
+    shift = y % 8;
+    page = y / 8;
+    invert = point ? 0x00 : 0xFF;
+
+    for (int k = 0; k * 8 < h; k++, page++)
+    {
+        if (page >= (s->height + 7) / 8)
+            break;
+
+        // 本字节内有效的行数（最后一个字节可能不足 8 行）
+        rows = (h - k * 8 >= 8) ? 8 : h - k * 8;
+        mask = OLED_TOP_ROWS(rows);
+        lo_mask = OLED_BYTE_DOWN(mask, shift);
+        hi_mask = shift ? OLED_BYTE_UP(mask, 8 - shift) : 0;
+        if (page + 1 >= (s->height + 7) / 8)
+            hi_mask = 0;
+
+        sp = src + k * page_stride;
+        dst = s->data + page * s->stride + x;
+        dst2 = dst + s->stride;
+
+        // 整页对齐、整字节、源数据连续：直接复制（字宽很短，循环复制比调用 memcpy 更快）
+        if (lo_mask == 0xFF && col_stride == 1 && !invert)
+        {
+            for (int c = 0; c < cols; c++)
+                dst[c] = sp[c];
+            continue;
+        }
+
+        for (int c = 0; c < cols; c++, sp += col_stride)
+        {
+            bits = (*sp ^ invert) & mask;
+            dst[c] = (dst[c] & ~lo_mask) | OLED_BYTE_DOWN(bits, shift);
+            if (hi_mask)
+                dst2[c] = (dst2[c] & ~hi_mask) | OLED_BYTE_UP(bits, 8 - shift);
+        }
+    }
+}
+
+/**
+ * @Description: 显示页式字模中的一个字，整页对齐时每页只需一次复制
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x: 起始x坐标
+ * @param {int} y: 起始y坐标
+ * @param {const FontStrip} *font: 字体
+ * @param {int} code: 字符编码
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*} 字宽，字符不存在时返回 0
+ */
+int OLED_ShowGlyph(Surface *s, int x, int y, const FontStrip *font, int code, uint8_t point)
+{
+    int index = code - font->first;
+
+    if (index < 0 || index >= font->count)
+        return 0;
+    OLED_BlitColumns(s, x, y, font->data + index * font->pages * font->width,
+                     font->widths[index], font->height, 1, font->width, point);
+    return font->widths[index];
+}
+
 /**
  * @Description: 显示单个英文字符
+ * @param {Surface} *s: 绘制目标
  * @param {uint8_t} x: 字符显示位置的起始x坐标
  * @param {uint8_t} y: 字符显示位置的起始y坐标
  * @param {uint8_t} chr: 显示字符的ascii码（0～94）
@@ -58,44 +158,24 @@ void OLED_DrawPoint(uint8_t x, uint8_t y, uint8_t point)
  * @param {uint8_t} point: 1 填充 0,清空
  * @return {*}
  */
-void OLED_ShowChar(uint8_t x, uint8_t y, uint8_t chr, uint8_t size, uint8_t point)
+void OLED_ShowChar(Surface *s, uint8_t x, uint8_t y, uint8_t chr, uint8_t size, uint8_t point)
 {
-    uint8_t temp, t, t1;
-    uint8_t y0 = y;
-    // 得到字体一个字符对应点阵集所占的字节数
-    uint8_t csize = (size / 8 + ((size % 8) ? 1 : 0)) * (size / 2); 
-    // 得到偏移后的值
-    chr = chr - ' ';
-    for (t = 0; t < csize; t++)
-    {
-        if (size == FONT_12)
-            temp = asc2_1206[chr][t]; // 调用1206字体
-        else if (size == FONT_16)
-            temp = asc2_1608[chr][t]; // 调用1608字体
-        else if (size == FONT_24)
-            temp = asc2_2412[chr][t]; // 调用2412字体
-        else
-            return; // 没有的字库
-        for (t1 = 0; t1 < 8; t1++)
-        {
-            if (temp & 0x80)
-                OLED_DrawPoint(x, y, point);
-            else
-                OLED_DrawPoint(x, y, !point);
-            temp <<= 1;
-            y++;
-            if ((y - y0) == size)
-            {
-                y = y0;
-                x++;
-                break;
-            }
-        }
-    }
+    const FontStrip *font;
+
+    if (size == FONT_12)
+        font = &font_1206; // 调用1206字体
+    else if (size == FONT_16)
+        font = &font_1608; // 调用1608字体
+    else if (size == FONT_24)
+        font = &font_2412; // 调用2412字体
+    else
+        return; // 没有的字库
+    OLED_ShowGlyph(s, x, y, font, chr, point);
 }
 
 /**
  * @Description: 显示中文字符串
+ * @param {Surface} *s: 绘制目标
  * @param {uint8_t} x: 汉语字符串的起始x坐标
  * @param {uint8_t} y: 汉语字符串的起始y坐标
  * @param {uint8_t} index: 二维字库中的列向量，第几个字
@@ -103,35 +183,16 @@ void OLED_ShowChar(uint8_t x, uint8_t y, uint8_t chr, uint8_t size, uint8_t poin
  * @param {uint8_t} point: 1 填充 0,清空
  * @return {*}
  */
-void OLED_Chinese_Text(uint8_t x, uint8_t y, uint8_t index, uint8_t size, uint8_t point)
+void OLED_Chinese_Text(Surface *s, uint8_t x, uint8_t y, uint8_t index, uint8_t size, uint8_t point)
 {
-    uint8_t temp, t, t1;
-    uint8_t y0 = y;
-    // 得到字体一个字符对应点阵集所占的字节数
-    uint8_t csize = (size / 8 + ((size % 8) ? 1 : 0)) * size;
-    for (t = 0; t < csize; t++)
-    {
-        temp = Chinese_Text[index][t];
-        for (t1 = 0; t1 < 8; t1++)
-        {
-            if (temp & 0x80)
-                OLED_DrawPoint(x, y, point);
-            else
-                OLED_DrawPoint(x, y, !point);
-            temp <<= 1;
-            y++;
-            if ((y - y0) == size)
-            {
-                y = y0;
-                x++;
-                break;
-            }
-        }
-    }
+    if (size != font_chinese16.height)
+        return; // 没有的字库
+    OLED_ShowGlyph(s, x, y, &font_chinese16, index, point);
 }
 
 /**
  * @Description: 显示数字
+ * @param {Surface} *s: 绘制目标
  * @param {uint8_t} x: 数字的起始x坐标
  * @param {uint8_t} y: 数字的起始y坐标
  * @param {uint32_t} num: 数字（0～4294967295）
@@ -139,7 +200,7 @@ void OLED_Chinese_Text(uint8_t x, uint8_t y, uint8_t index, uint8_t size, uint8_
  * @param {uint8_t} size: 显示数字的大小
  * @return {*}
  */
-void OLED_ShowNum(uint8_t x, uint8_t y, uint32_t num, uint8_t len, uint8_t size)
+void OLED_ShowNum(Surface *s, uint8_t x, uint8_t y, uint32_t num, uint8_t len, uint8_t size)
 {
     uint8_t t, temp;
     uint8_t enshow = 0; // 用于控制是否显示前导零。如果 enshow 为 0 且当前位是前导零，则显示空格
@@ -157,7 +218,7 @@ void OLED_ShowNum(uint8_t x, uint8_t y, uint32_t num, uint8_t len, uint8_t size)
         // 处理前导零
         if (enshow == 0 && t < (len - 1)) {
             if (temp == 0) {
-                OLED_ShowChar(x + (size / 2) * t, y, ' ', size, 1);
+                OLED_ShowChar(s, x + (size / 2) * t, y, ' ', size, 1);
                 continue;
             } else {
                 enshow = 1; // 遇到非零数字后，允许显示后续的零
@@ -165,49 +226,495 @@ void OLED_ShowNum(uint8_t x, uint8_t y, uint32_t num, uint8_t len, uint8_t size)
         }
 
         // 显示当前位的数字
-        OLED_ShowChar(x + (size / 2) * t, y, temp + '0', size, 1);
+        OLED_ShowChar(s, x + (size / 2) * t, y, temp + '0', size, 1);
     }
 }
 /***************************** 区域操作 ******************************/
 /**
  * @Description: 显示白色背景
- * @param {char} *buffer: 缓冲区
- * @param {size_t} size: 缓冲区大小
+ * @param {Surface} *s: 绘制目标
  * @return {*}
  */
-void OLED_display_white(void) {
-    memset(buffer, 0xFF, size);
+void OLED_display_white(Surface *s) {
+    OLED_Fill(s, 0, 0, s->width - 1, s->height - 1, 1);
 }
 /**
  * @Description: 清空
- * @param {char} *buffer: 缓冲区
- * @param {size_t} size: 缓冲区大小
+ * @param {Surface} *s: 绘制目标
  * @return {*}
  */
-void OLED_Clear(void) {
-    memset(buffer, 0x00, size);
+void OLED_Clear(Surface *s) {
+    OLED_Fill(s, 0, 0, s->width - 1, s->height - 1, 0);
 }
 /**
- * @Description: 填充指定区域
- * @param {uint8_t} x1: 起始x坐标
- * @param {uint8_t} y1: 起始y坐标
- * @param {uint8_t} x2: 结束x坐标
- * @param {uint8_t} y2: 结束y坐标
+ * @Description: 填充指定区域，按页计算一次掩码，整页覆盖时直接 memset
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x1: 起始x坐标
+ * @param {int} y1: 起始y坐标
+ * @param {int} x2: 结束x坐标（包含）
+ * @param {int} y2: 结束y坐标（包含）
  * @param {uint8_t} point: 1 填充 0,清空
  * @return {*}
  */
-void OLED_Fill(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t point)
+void OLED_Fill(Surface *s, int x1, int y1, int x2, int y2, uint8_t point)
 {
-    uint8_t x, y;
-    for (x = x1; x <= x2; x++)
+    int w, p, p_end, r0, r1;
+    uint8_t mask, *row;
+
+    // 裁剪到屏幕范围
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= s->width) x2 = s->width - 1;
+    if (y2 >= s->height) y2 = s->height - 1;
+    if (x1 > x2 || y1 > y2)
+        return;
+
+    w = x2 - x1 + 1;
+    p_end = y2 / 8;
+    for (p = y1 / 8; p <= p_end; p++)
     {
-        for (y = y1; y <= y2; y++)
-            OLED_DrawPoint(x, y, point);
+        // 本页覆盖的行
+        r0 = (p == y1 / 8) ? y1 % 8 : 0;
+        r1 = (p == p_end) ? y2 % 8 : 7;
+        mask = OLED_ROWS_MASK(r0, r1);
+        row = s->data + p * s->stride + x1;
+
+        if (mask == 0xFF)
+            memset(row, point ? 0xFF : 0x00, w);
+        else if (point)
+            for (int c = 0; c < w; c++)
+                row[c] |= mask;
+        else
+            for (int c = 0; c < w; c++)
+                row[c] &= ~mask;
     }
 }
 
+/***************************** 字级并行操作 ******************************/
+/* 每个字节都是 b 的 64 位字，按字节移位/掩码（SWAR）时使用 */
+#define LANES(b) (0x0101010101010101ULL * (uint8_t)(b))
+
+/**
+ * @Description: 区域在第 p 页中覆盖的行
+ * @param {int} p: 页号
+ * @param {int} y1: 区域起始行
+ * @param {int} y2: 区域结束行（包含）
+ * @return {*} 页内行掩码
+ */
+static inline uint8_t region_rows(int p, int y1, int y2)
+{
+    int r0 = (p == y1 / 8) ? y1 % 8 : 0;
+    int r1 = (p == y2 / 8) ? y2 % 8 : 7;
+
+    return OLED_ROWS_MASK(r0, r1);
+}
+
+/**
+ * @Description: 一页中连续 n 列的垂直移位：每列由源的相邻两页拼出 8 行，写入本页的 m 行
+ *               v = (lo & lo_m) >> sh | (hi & hi_m) << (8 - sh)，d = (d & ~m) | (v & m)
+ *               一次处理 8 列（64 位，NEON 为 16 列），源页在区域外时掩码为 0
+ * @param {uint8_t} *d: 本页起始列
+ * @param {const uint8_t} *lo: 源的上面一页
+ * @param {const uint8_t} *hi: 源的下面一页
+ * @param {uint8_t} lo_m: lo 中属于区域的行
+ * @param {uint8_t} hi_m: hi 中属于区域的行
+ * @param {uint8_t} m: 本页中属于区域的行
+ * @param {int} sh: 本页第 0 行在 lo 中的行号（0~7）
+ * @param {int} n: 列数
+ * @return {*}
+ */
+static void shift_span(uint8_t *d, const uint8_t *lo, const uint8_t *hi, uint8_t lo_m, uint8_t hi_m,
+                       uint8_t m, int sh, int n)
+{
+    uint8_t rm = 0xFF >> sh, km = (uint8_t)(0xFF << (8 - sh));
+    int c = 0;
+
+#if defined(__ARM_NEON)
+    uint8x16_t vlm = vdupq_n_u8(lo_m), vhm = vdupq_n_u8(hi_m), vm = vdupq_n_u8(m);
+    int8x16_t rs = vdupq_n_s8(-sh), ls = vdupq_n_s8(8 - sh);
+
+    for (; c + 16 <= n; c += 16) {
+        uint8x16_t a = vandq_u8(vld1q_u8(lo + c), vlm);
+        uint8x16_t b = vandq_u8(vld1q_u8(hi + c), vhm);
+        uint8x16_t v = vorrq_u8(vshlq_u8(a, rs), vshlq_u8(b, ls));
+        vst1q_u8(d + c, vbslq_u8(vm, v, vld1q_u8(d + c)));
+    }
+#endif
+    for (; c + 8 <= n; c += 8) {
+        uint64_t a, b, o, v;
+
+        memcpy(&a, lo + c, 8);
+        memcpy(&b, hi + c, 8);
+        memcpy(&o, d + c, 8);
+        a &= LANES(lo_m);
+        b &= LANES(hi_m);
+        v = ((a >> sh) & LANES(rm)) | ((b << (8 - sh)) & LANES(km));
+        o = (o & ~LANES(m)) | (v & LANES(m));
+        memcpy(d + c, &o, 8);
+    }
+    for (; c < n; c++) {
+        unsigned v = ((lo[c] & lo_m) | (hi[c] & hi_m) << 8) >> sh;
+        d[c] = (d[c] & ~m) | (v & m);
+    }
+}
+
+/**
+ * @Description: 区域内容垂直移动 n 行（像素），跨页的位每次移动 8 列，不需要重绘
+ *               移出区域的行丢弃，空出的行清零
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x1: 起始x坐标
+ * @param {int} y1: 起始y坐标
+ * @param {int} x2: 结束x坐标（包含）
+ * @param {int} y2: 结束y坐标（包含）
+ * @param {int} n: 移动的行数，正数向下，负数向上
+ * @return {*}
+ */
+void OLED_ShiftRows(Surface *s, int x1, int y1, int x2, int y2, int n)
+{
+    int p0, p1, w;
+
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= s->width) x2 = s->width - 1;
+    if (y2 >= s->height) y2 = s->height - 1;
+    if (x1 > x2 || y1 > y2 || n == 0)
+        return;
+    if (n >= y2 - y1 + 1 || -n >= y2 - y1 + 1)
+    {
+        OLED_Fill(s, x1, y1, x2, y2, 0);
+        return;
+    }
+
+    w = x2 - x1 + 1;
+    p0 = y1 / 8;
+    p1 = y2 / 8;
+    for (int i = 0; i <= p1 - p0; i++)
+    {
+        // 向下移动时从下往上处理，向上移动时从上往下，读取的源页都还没有被改写
+        int p = n > 0 ? p1 - i : p0 + i;
+        int r = p * 8 - n;                          // 本页第 0 行的内容来自第 r 行
+        int q = r >= 0 ? r / 8 : -((7 - r) / 8);    // 向下取整
+        int sh = r - q * 8;
+        uint8_t *d = s->data + p * s->stride + x1;
+        const uint8_t *lo = d, *hi = d;
+        uint8_t lo_m = 0, hi_m = 0;
+
+        if (q >= p0 && q <= p1)
+        {
+            lo = s->data + q * s->stride + x1;
+            lo_m = region_rows(q, y1, y2);
+        }
+        if (sh && q + 1 >= p0 && q + 1 <= p1)
+        {
+            hi = s->data + (q + 1) * s->stride + x1;
+            hi_m = region_rows(q + 1, y1, y2);
+        }
+        shift_span(d, lo, hi, lo_m, hi_m, region_rows(p, y1, y2), sh, w);
+    }
+}
+
+/**
+ * @Description: 一页中只有部分行属于区域时的水平移动，每次合并 8 列
+ * @param {uint8_t} *row: 区域在本页的起始列
+ * @param {int} w: 区域宽度
+ * @param {int} n: 移动的列数（小于 w），正数向右，负数向左
+ * @param {uint8_t} m: 本页中属于区域的行
+ * @return {*}
+ */
+static void merge_shift(uint8_t *row, int w, int n, uint8_t m)
+{
+    uint64_t a, b, mm = LANES(m);
+    int c;
+
+    if (n < 0)
+    {
+        // 向左：从左往右处理，读取的列总在已写入的列右边
+        n = -n;
+        for (c = 0; c + 8 <= w - n; c += 8)
+        {
+            memcpy(&a, row + c, 8);
+            memcpy(&b, row + c + n, 8);
+            a = (a & ~mm) | (b & mm);
+            memcpy(row + c, &a, 8);
+        }
+        for (; c < w - n; c++)
+            row[c] = (row[c] & ~m) | (row[c + n] & m);
+        for (; c < w; c++)
+            row[c] &= ~m;
+        return;
+    }
+
+    // 向右：从右往左处理
+    for (c = w - 8; c >= n; c -= 8)
+    {
+        memcpy(&a, row + c, 8);
+        memcpy(&b, row + c - n, 8);
+        a = (a & ~mm) | (b & mm);
+        memcpy(row + c, &a, 8);
+    }
+    for (c += 7; c >= n; c--)
+        row[c] = (row[c] & ~m) | (row[c - n] & m);
+    for (; c >= 0; c--)
+        row[c] &= ~m;
+}
+
+/**
+ * @Description: 区域内容水平移动 n 列，空出的列清零（滚动图表每次只需要画新的一列）
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x1: 起始x坐标
+ * @param {int} y1: 起始y坐标
+ * @param {int} x2: 结束x坐标（包含）
+ * @param {int} y2: 结束y坐标（包含）
+ * @param {int} n: 移动的列数，正数向右，负数向左
+ * @return {*}
+ */
+void OLED_ShiftColumns(Surface *s, int x1, int y1, int x2, int y2, int n)
+{
+    int w, k, p, p_end;
+    uint8_t mask, *row;
+
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= s->width) x2 = s->width - 1;
+    if (y2 >= s->height) y2 = s->height - 1;
+    if (x1 > x2 || y1 > y2 || n == 0)
+        return;
+    w = x2 - x1 + 1;
+    k = n > 0 ? n : -n;
+    if (k >= w)
+    {
+        OLED_Fill(s, x1, y1, x2, y2, 0);
+        return;
+    }
+
+    p_end = y2 / 8;
+    for (p = y1 / 8; p <= p_end; p++)
+    {
+        mask = region_rows(p, y1, y2);
+        row = s->data + p * s->stride + x1;
+
+        if (mask != 0xFF)
+        {
+            // 只移动本页中属于该区域的行，其余行保持不变
+            merge_shift(row, w, n, mask);
+        }
+        else if (n < 0)
+        {
+            memmove(row, row + k, w - k);
+            memset(row + w - k, 0x00, k);
+        }
+        else
+        {
+            memmove(row + k, row, w - k);
+            memset(row, 0x00, k);
+        }
+    }
+}
+
+/**
+ * @Description: 区域反色，每次异或 8 列
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x1: 起始x坐标
+ * @param {int} y1: 起始y坐标
+ * @param {int} x2: 结束x坐标（包含）
+ * @param {int} y2: 结束y坐标（包含）
+ * @return {*}
+ */
+void OLED_Invert(Surface *s, int x1, int y1, int x2, int y2)
+{
+    int w, c;
+    uint8_t mask, *row;
+
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= s->width) x2 = s->width - 1;
+    if (y2 >= s->height) y2 = s->height - 1;
+    if (x1 > x2 || y1 > y2)
+        return;
+
+    w = x2 - x1 + 1;
+    for (int p = y1 / 8; p <= y2 / 8; p++)
+    {
+        uint64_t x;
+
+        mask = region_rows(p, y1, y2);
+        row = s->data + p * s->stride + x1;
+        for (c = 0; c + 8 <= w; c += 8)
+        {
+            memcpy(&x, row + c, 8);
+            x ^= LANES(mask);
+            memcpy(row + c, &x, 8);
+        }
+        for (; c < w; c++)
+            row[c] ^= mask;
+    }
+}
+
+/**
+ * @Description: 按掩码合并：掩码为 1 的位取 src，其余保持 dst，dst = (dst & ~mask) | (src & mask)
+ * @param {uint8_t} *dst: 目标
+ * @param {const uint8_t} *src: 源
+ * @param {const uint8_t} *mask: 掩码
+ * @param {size_t} n: 字节数
+ * @return {*}
+ */
+void OLED_MergeMasked(uint8_t *dst, const uint8_t *src, const uint8_t *mask, size_t n)
+{
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i m = _mm_loadu_si128((const __m128i *)(mask + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(_mm_andnot_si128(m, d), _mm_and_si128(a, m)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= n; i += 16)
+        vst1q_u8(dst + i, vbslq_u8(vld1q_u8(mask + i), vld1q_u8(src + i), vld1q_u8(dst + i)));
+#endif
+    for (; i + 8 <= n; i += 8) {
+        uint64_t d, a, m;
+
+        memcpy(&d, dst + i, 8);
+        memcpy(&a, src + i, 8);
+        memcpy(&m, mask + i, 8);
+        d = (d & ~m) | (a & m);
+        memcpy(dst + i, &d, 8);
+    }
+    for (; i < n; i++)
+        dst[i] = (dst[i] & ~mask[i]) | (src[i] & mask[i]);
+}
+
+/**
+ * @Description: 统计点亮的像素数（x86 每次 64 位 popcount，NEON 每次 16 字节）
+ * @param {const uint8_t} *buf: 页式数据
+ * @param {size_t} n: 字节数
+ * @return {*} 为 1 的位数
+ */
+uint32_t OLED_PopCount(const uint8_t *buf, size_t n)
+{
+    uint32_t count = 0;
+    size_t i = 0;
+
+#if defined(__ARM_NEON)
+    uint32x4_t acc = vdupq_n_u32(0);
+
+    for (; i + 16 <= n; i += 16)
+        acc = vpadalq_u16(acc, vpaddlq_u8(vcntq_u8(vld1q_u8(buf + i))));
+    count = vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1) + vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3);
+#endif
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x;
+
+        memcpy(&x, buf + i, 8);
+        count += __builtin_popcountll(x);
+    }
+    for (; i < n; i++)
+        count += __builtin_popcount(buf[i]);
+    return count;
+}
+
+/**
+ * @Description: 统计两帧之间变化的像素数，用于估计刷新量（例如决定局部刷新还是整屏刷新）
+ * @param {const uint8_t} *a: 旧画面
+ * @param {const uint8_t} *b: 新画面
+ * @param {size_t} n: 字节数
+ * @return {*} 不同的位数
+ */
+uint32_t OLED_DiffCount(const uint8_t *a, const uint8_t *b, size_t n)
+{
+    uint32_t count = 0;
+    size_t i = 0;
+
+#if defined(__ARM_NEON)
+    uint32x4_t acc = vdupq_n_u32(0);
+
+    for (; i + 16 <= n; i += 16)
+        acc = vpadalq_u16(acc, vpaddlq_u8(vcntq_u8(veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i)))));
+    count = vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1) + vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3);
+#endif
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x, y;
+
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        count += __builtin_popcountll(x ^ y);
+    }
+    for (; i < n; i++)
+        count += __builtin_popcount(a[i] ^ b[i]);
+    return count;
+}
+
+/**
+ * @Description: 每页变化的列范围转换为脏矩形，相邻且列范围相同的页合并
+ * @param {const short} *x0: 每页变化的起始列
+ * @param {const short} *x1: 每页变化的结束列，-1 表示该页没有变化
+ * @param {Rect} *damage: 输出脏矩形
+ * @param {int} max_damage: 脏矩形数组大小，不够时合并到最后一个
+ * @return {*} 脏矩形个数
+ */
+int OLED_PageDamage(const short *x0, const short *x1, Rect *damage, int max_damage)
+{
+    int n = 0;
+
+    for (int p = 0; p < FRAME_HEIGHT / 8 && max_damage > 0; p++)
+    {
+        if (x1[p] < 0)
+            continue;
+        if (n > 0 && damage[n - 1].y1 == p * 8 - 1 &&
+            damage[n - 1].x0 == x0[p] && damage[n - 1].x1 == x1[p])
+        {
+            damage[n - 1].y1 = p * 8 + 7;
+        }
+        else if (n < max_damage)
+        {
+            damage[n++] = (Rect){ x0[p], p * 8, x1[p], p * 8 + 7 };
+        }
+        else
+        {
+            Rect *m = &damage[n - 1];
+            if (x0[p] < m->x0) m->x0 = x0[p];
+            if (x1[p] > m->x1) m->x1 = x1[p];
+            m->y1 = p * 8 + 7;
+        }
+    }
+    return n;
+}
+
+/**
+ * @Description: 比较两帧，得到变化的区域
+ * @param {const uint8_t} *old: 原来的帧
+ * @param {const uint8_t} *cur: 新的帧
+ * @param {Rect} *damage: 输出脏矩形
+ * @param {int} max_damage: 脏矩形数组大小
+ * @return {*} 脏矩形个数，0 表示两帧相同
+ */
+int OLED_DiffDamage(const uint8_t *old, const uint8_t *cur, Rect *damage, int max_damage)
+{
+    short x0[FRAME_HEIGHT / 8], x1[FRAME_HEIGHT / 8];
+
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++)
+    {
+        const uint8_t *a = old + p * FRAME_WIDTH, *b = cur + p * FRAME_WIDTH;
+        int l = 0, r = FRAME_WIDTH - 1;
+
+        x1[p] = -1;
+        if (memcmp(a, b, FRAME_WIDTH) == 0)
+            continue;
+        while (a[l] == b[l])
+            l++;
+        while (a[r] == b[r])
+            r--;
+        x0[p] = l;
+        x1[p] = r;
+    }
+    return OLED_PageDamage(x0, x1, damage, max_damage);
+}
+
 /**
  * @Description: 显示显示BMP图片
+ * @param {Surface} *s: 绘制目标
  * @param {uint8_t} x1: 起始x坐标
  * @param {uint8_t} y1: 起始y坐标
  * @param {uint8_t} page: 图片帧号，第几帧
@@ -215,60 +722,477 @@ void OLED_Fill(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t point)
  * @param {uint8_t} image_y: 图像宽
  * @return {*}
  */
-void OLED_DrawBMP(uint8_t x, uint8_t y, uint8_t page, uint8_t image_x, uint8_t image_y)
+void OLED_DrawBMP(Surface *s, uint8_t x, uint8_t y, uint8_t page, uint8_t image_x, uint8_t image_y)
 {
-    uint8_t point_byte; /* 图像数组每一字节 */
-    uint8_t t2, t1;
-    uint8_t y0 = y;
-    // 得到每一帧所占的字节数
-    uint8_t csize = (image_y / 8 + ((image_y % 8) ? 1 : 0)) * image_x;
+    // 图像每列所占的字节数
+    int bytes_per_col = image_y / 8 + ((image_y % 8) ? 1 : 0);
+    uint8_t image[sizeof(GIF_image[0])];
 
-    for (t2 = 0; t2 < csize; t2++) /* 按字节写入 */
-    {
-        point_byte = GIF_image[page][t2];
-        for (t1 = 0; t1 < 8; t1++) /* 字节内每一像素点 */
-        {
-            if (point_byte & 0x80)
-                OLED_DrawPoint(x, y, 1);
-            else
-                OLED_DrawPoint(x, y, 0);
-            point_byte <<= 1;
-            y++;
-            if ((y - y0) == image_y)
-            {
-                y = y0;
-                x++;
-                break;
-            }
-        }
-    }
+    // 取模数据最高位在上，转换为帧缓冲位序
+    for (size_t i = 0; i < sizeof(image); i++)
+        image[i] = OLED_ReverseByte(GIF_image[page][i]);
+    OLED_BlitColumns(s, x, y, image, image_x, image_y, bytes_per_col, 1, 1);
+}
+
+/**
+ * @Description: 设置外部字库，OLED_ShowString 中的非 ASCII 字符从这里查找
+ * @param {const OlfFont} *font: 已加载的字库，NULL 表示只显示 ASCII
+ * @return {*}
+ */
+void OLED_SetFont(const OlfFont *font)
+{
+    ext_font = font;
 }
 
 /**
- * @Description: 显示英文字符串
+ * @Description: 取出字符串中的下一个可显示字符
+ * @param {const uint8_t} **p: 字符串位置，返回后指向下一个字符
+ * @param {uint8_t} size: ASCII 字符的大小
+ * @param {const OlfGlyph} **glyph: 输出外部字库中的字，ASCII 字符为 NULL
+ * @return {*} 字宽，0 表示字库中没有该字，-1 表示字符串结束
+ */
+static int next_glyph(const uint8_t **p, uint8_t size, const OlfGlyph **glyph)
+{
+    uint32_t code = utf8_next(p);
+
+    *glyph = NULL;
+    if (code >= ' ' && code <= '~')
+        return size / 2;
+    if (code < 0x80) // 结尾或控制字符
+        return -1;
+    if (ext_font && (*glyph = font_find(ext_font, code)))
+        return (*glyph)->width;
+    return 0;
+}
+
+/**
+ * @Description: 计算字符串的显示宽度（不换行）
+ * @param {const uint8_t} *p: UTF-8 字符串
+ * @param {uint8_t} size: ASCII 字符的大小
+ * @return {*} 宽度（像素）
+ */
+int OLED_StringWidth(const uint8_t *p, uint8_t size)
+{
+    const OlfGlyph *glyph;
+    int w, width = 0;
+
+    while ((w = next_glyph(&p, size, &glyph)) >= 0)
+        width += w;
+    return width;
+}
+
+/**
+ * @Description: 显示字符串，ASCII 使用内置字体，其他字符（如中文）从外部字库查找
+ * @param {Surface} *s: 绘制目标
  * @param {uint8_t} x: 字符串的起始x坐标
  * @param {uint8_t} y: 字符串的起始y坐标
- * @param {uint8_t} *p: 字符串起始地址
+ * @param {uint8_t} *p: UTF-8 字符串起始地址
  * @param {uint8_t} size: 显示字符的大小
  * @return {*}
  */
-void OLED_ShowString(uint8_t x, uint8_t y, const uint8_t *p, uint8_t size)
+void OLED_ShowString(Surface *s, uint8_t x, uint8_t y, const uint8_t *p, uint8_t size)
 {
-    while ((*p <= '~') && (*p >= ' ')) // 判断是不是非法字符!
+    const uint8_t *c;
+    const OlfGlyph *glyph;
+    int w;
+
+    for (c = p; (w = next_glyph(&p, size, &glyph)) >= 0; c = p) // 遇到非法字符结束
     {
-        if (x > (FRAME_WIDTH - (size / 2)))
+        if (w == 0) // 字库中没有的字跳过
+            continue;
+        if (x > (s->width - w))
         {
             x = 0;
             y += size;
         }
-        if (y > (FRAME_HEIGHT - size))
+        if (y > (s->height - size))
         {
             y = x = 0;
-            OLED_Clear();
+            OLED_Clear(s);
+        }
+        if (glyph)
+            OLED_BlitColumns(s, x, y, font_bitmap(ext_font, glyph), glyph->width,
+                             ext_font->header->height, 1, glyph->width, 1);
+        else
+            OLED_ShowChar(s, x, y, *c, size, 1);
+        x += w;
+    }
+}
+
+/**
+ * @Description: 在一行内显示字符串，不换行，超出 max_w 的部分裁掉（控件中的文本）
+ *               外部字库的字逐列复制，可以只显示一部分；ASCII 字符放不下时结束
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x: 字符串的起始x坐标
+ * @param {int} y: 字符串的起始y坐标
+ * @param {const uint8_t} *p: UTF-8 字符串起始地址
+ * @param {uint8_t} size: ASCII 字符的大小
+ * @param {int} max_w: 最大宽度（像素）
+ * @return {*} 实际绘制的宽度
+ */
+int OLED_ShowStringClip(Surface *s, int x, int y, const uint8_t *p, uint8_t size, int max_w)
+{
+    const uint8_t *c;
+    const OlfGlyph *glyph;
+    int w, used = 0;
+
+    for (c = p; used < max_w && (w = next_glyph(&p, size, &glyph)) >= 0; c = p)
+    {
+        if (w == 0) // 字库中没有的字跳过
+            continue;
+        if (glyph) {
+            int cols = w < max_w - used ? w : max_w - used;
+
+            // 字库比 ASCII 字体高时只显示一行的高度，不画到下一行
+            int rows = ext_font->header->height < size ? ext_font->header->height : size;
+
+            OLED_BlitColumns(s, x + used, y, font_bitmap(ext_font, glyph), cols, rows, 1, glyph->width, 1);
+            used += cols;
+        } else {
+            if (w > max_w - used)
+                break;
+            OLED_ShowChar(s, x + used, y, *c, size, 1);
+            used += w;
+        }
+    }
+    return used;
+}
+
+/***************************** 图形绘制 ******************************/
+/**
+ * @Description: 不做边界检查的画点，调用者保证坐标在屏幕内
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x: x 坐标
+ * @param {int} y: y 坐标
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*}
+ */
+static inline void plot_unchecked(Surface *s, int x, int y, uint8_t point)
+{
+    uint8_t *byte = s->data + (y / 8) * s->stride + x;
+
+    if (point)
+        *byte |= OLED_PIXEL_MASK(y);
+    else
+        *byte &= ~OLED_PIXEL_MASK(y);
+}
+
+/**
+ * @Description: 画点，clip 为 0 时跳过边界检查（整个图元已确认在屏幕内）
+ * @param {Surface} *s: 绘制目标
+ * @return {*}
+ */
+static inline void plot(Surface *s, int x, int y, uint8_t point, int clip)
+{
+    if (clip && (x < 0 || y < 0 || x >= s->width || y >= s->height))
+        return;
+    plot_unchecked(s, x, y, point);
+}
+
+/**
+ * @Description: 判断矩形是否完全在屏幕内
+ * @param {Surface} *s: 绘制目标
+ * @return {*} 1 完全在屏幕内
+ */
+static inline int inside(Surface *s, int x1, int y1, int x2, int y2)
+{
+    return x1 >= 0 && y1 >= 0 && x2 < s->width && y2 < s->height;
+}
+
+/**
+ * @Description: 水平线，只计算一次页掩码
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x1: 起始x坐标
+ * @param {int} x2: 结束x坐标（包含）
+ * @param {int} y: y 坐标
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*}
+ */
+void OLED_DrawHLine(Surface *s, int x1, int x2, int y, uint8_t point)
+{
+    if (x1 > x2) {
+        int t = x1; x1 = x2; x2 = t;
+    }
+    OLED_Fill(s, x1, y, x2, y, point);
+}
+
+/**
+ * @Description: 垂直线，中间整页直接写 0xFF/0x00
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x: x 坐标
+ * @param {int} y1: 起始y坐标
+ * @param {int} y2: 结束y坐标（包含）
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*}
+ */
+void OLED_DrawVLine(Surface *s, int x, int y1, int y2, uint8_t point)
+{
+    if (y1 > y2) {
+        int t = y1; y1 = y2; y2 = t;
+    }
+    OLED_Fill(s, x, y1, x, y2, point);
+}
+
+/**
+ * @Description: 任意直线（Bresenham），水平/垂直线走快速路径
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x0: 起点x坐标
+ * @param {int} y0: 起点y坐标
+ * @param {int} x1: 终点x坐标
+ * @param {int} y1: 终点y坐标
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*}
+ */
+void OLED_DrawLine(Surface *s, int x0, int y0, int x1, int y1, uint8_t point)
+{
+    int dx, dy, sx, sy, err, e2, clip;
+
+    if (y0 == y1) {
+        OLED_DrawHLine(s, x0, x1, y0, point);
+        return;
+    }
+    if (x0 == x1) {
+        OLED_DrawVLine(s, x0, y0, y1, point);
+        return;
+    }
+
+    // 两个端点都在屏幕内时整条线都在屏幕内，逐点不再检查边界
+    clip = !(inside(s, x0, y0, x0, y0) && inside(s, x1, y1, x1, y1));
+
+    dx = abs(x1 - x0);
+    dy = -abs(y1 - y0);
+    sx = x0 < x1 ? 1 : -1;
+    sy = y0 < y1 ? 1 : -1;
+    err = dx + dy;
+    while (1)
+    {
+        plot(s, x0, y0, point, clip);
+        if (x0 == x1 && y0 == y1)
+            break;
+        e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+/**
+ * @Description: 矩形边框
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x1: 左上角x坐标
+ * @param {int} y1: 左上角y坐标
+ * @param {int} x2: 右下角x坐标（包含）
+ * @param {int} y2: 右下角y坐标（包含）
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*}
+ */
+void OLED_DrawRect(Surface *s, int x1, int y1, int x2, int y2, uint8_t point)
+{
+    OLED_Fill(s, x1, y1, x2, y1, point);
+    OLED_Fill(s, x1, y2, x2, y2, point);
+    OLED_Fill(s, x1, y1, x1, y2, point);
+    OLED_Fill(s, x2, y1, x2, y2, point);
+}
+
+/**
+ * @Description: 按中点圆算法画出四个象限的圆弧，圆角矩形和圆共用
+ *               (xl, yt) 为左上圆心，(xr, yb) 为右下圆心，圆时四个圆心相同
+ * @param {Surface} *s: 绘制目标
+ * @return {*}
+ */
+static void draw_arcs(Surface *s, int xl, int yt, int xr, int yb, int r, uint8_t point)
+{
+    int x = r, y = 0, err = 1 - r;
+    int clip = !inside(s, xl - r, yt - r, xr + r, yb + r);
+
+    while (x >= y)
+    {
+        plot(s, xr + x, yb + y, point, clip);
+        plot(s, xr + y, yb + x, point, clip);
+        plot(s, xl - y, yb + x, point, clip);
+        plot(s, xl - x, yb + y, point, clip);
+        plot(s, xl - x, yt - y, point, clip);
+        plot(s, xl - y, yt - x, point, clip);
+        plot(s, xr + y, yt - x, point, clip);
+        plot(s, xr + x, yt - y, point, clip);
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+/**
+ * @Description: 按中点圆算法填充，每次输出一条水平跨度
+ *               (xl, yt) 为左上圆心，(xr, yb) 为右下圆心
+ * @param {Surface} *s: 绘制目标
+ * @return {*}
+ */
+static void fill_arcs(Surface *s, int xl, int yt, int xr, int yb, int r, uint8_t point)
+{
+    int x = r, y = 0, err = 1 - r;
+
+    // 圆心之间的矩形部分
+    OLED_Fill(s, xl - r, yt, xr + r, yb, point);
+    while (x >= y)
+    {
+        if (y > 0) {
+            OLED_Fill(s, xl - x, yt - y, xr + x, yt - y, point);
+            OLED_Fill(s, xl - x, yb + y, xr + x, yb + y, point);
+        }
+        if (err >= 0 && x != y) {
+            // x 即将减小，此时输出外侧的跨度，避免重复填充同一行
+            OLED_Fill(s, xl - y, yt - x, xr + y, yt - x, point);
+            OLED_Fill(s, xl - y, yb + x, xr + y, yb + x, point);
+        }
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+/**
+ * @Description: 圆
+ * @param {Surface} *s: 绘制目标
+ * @param {int} xc: 圆心x坐标
+ * @param {int} yc: 圆心y坐标
+ * @param {int} r: 半径
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*}
+ */
+void OLED_DrawCircle(Surface *s, int xc, int yc, int r, uint8_t point)
+{
+    if (r < 0)
+        return;
+    draw_arcs(s, xc, yc, xc, yc, r, point);
+}
+
+/**
+ * @Description: 实心圆
+ * @param {Surface} *s: 绘制目标
+ * @param {int} xc: 圆心x坐标
+ * @param {int} yc: 圆心y坐标
+ * @param {int} r: 半径
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*}
+ */
+void OLED_FillCircle(Surface *s, int xc, int yc, int r, uint8_t point)
+{
+    if (r < 0)
+        return;
+    fill_arcs(s, xc, yc, xc, yc, r, point);
+}
+
+/**
+ * @Description: 限制圆角半径不超过矩形短边的一半
+ * @return {*}
+ */
+static int round_radius(int x1, int y1, int x2, int y2, int r)
+{
+    int half = ((x2 - x1 < y2 - y1) ? x2 - x1 : y2 - y1) / 2;
+    return r > half ? half : (r < 0 ? 0 : r);
+}
+
+/**
+ * @Description: 圆角矩形边框
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x1: 左上角x坐标
+ * @param {int} y1: 左上角y坐标
+ * @param {int} x2: 右下角x坐标（包含）
+ * @param {int} y2: 右下角y坐标（包含）
+ * @param {int} r: 圆角半径
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*}
+ */
+void OLED_DrawRoundRect(Surface *s, int x1, int y1, int x2, int y2, int r, uint8_t point)
+{
+    if (x1 > x2 || y1 > y2)
+        return;
+    r = round_radius(x1, y1, x2, y2, r);
+    OLED_Fill(s, x1 + r, y1, x2 - r, y1, point);
+    OLED_Fill(s, x1 + r, y2, x2 - r, y2, point);
+    OLED_Fill(s, x1, y1 + r, x1, y2 - r, point);
+    OLED_Fill(s, x2, y1 + r, x2, y2 - r, point);
+    draw_arcs(s, x1 + r, y1 + r, x2 - r, y2 - r, r, point);
+}
+
+/**
+ * @Description: 实心圆角矩形
+ * @param {Surface} *s: 绘制目标
+ * @param {int} x1: 左上角x坐标
+ * @param {int} y1: 左上角y坐标
+ * @param {int} x2: 右下角x坐标（包含）
+ * @param {int} y2: 右下角y坐标（包含）
+ * @param {int} r: 圆角半径
+ * @param {uint8_t} point: 1 填充 0,清空
+ * @return {*}
+ */
+void OLED_FillRoundRect(Surface *s, int x1, int y1, int x2, int y2, int r, uint8_t point)
+{
+    if (x1 > x2 || y1 > y2)
+        return;
+    r = round_radius(x1, y1, x2, y2, r);
+    fill_arcs(s, x1 + r, y1 + r, x2 - r, y2 - r, r, point);
+}
+
+/**
+ * @Description: 批量绘制图元，每个图元只做一次裁剪和掩码计算
+ * @param {Surface} *s: 绘制目标
+ * @param {const DrawCmd} *cmds: 图元数组
+ * @param {int} count: 图元个数
+ * @return {*}
+ */
+void OLED_DrawList(Surface *s, const DrawCmd *cmds, int count)
+{
+    for (const DrawCmd *c = cmds; c < cmds + count; c++)
+    {
+        switch (c->op) {
+            case DRAW_POINT:
+                plot(s, c->x0, c->y0, c->point, 1);
+                break;
+            case DRAW_HLINE:
+                OLED_DrawHLine(s, c->x0, c->x1, c->y0, c->point);
+                break;
+            case DRAW_VLINE:
+                OLED_DrawVLine(s, c->x0, c->y0, c->y1, c->point);
+                break;
+            case DRAW_LINE:
+                OLED_DrawLine(s, c->x0, c->y0, c->x1, c->y1, c->point);
+                break;
+            case DRAW_RECT:
+                OLED_DrawRect(s, c->x0, c->y0, c->x1, c->y1, c->point);
+                break;
+            case DRAW_FILL:
+                OLED_Fill(s, c->x0, c->y0, c->x1, c->y1, c->point);
+                break;
+            case DRAW_CIRCLE:
+                OLED_DrawCircle(s, c->x0, c->y0, c->r, c->point);
+                break;
+            case DRAW_FILL_CIRCLE:
+                OLED_FillCircle(s, c->x0, c->y0, c->r, c->point);
+                break;
+            case DRAW_ROUND_RECT:
+                OLED_DrawRoundRect(s, c->x0, c->y0, c->x1, c->y1, c->r, c->point);
+                break;
+            case DRAW_FILL_ROUND_RECT:
+                OLED_FillRoundRect(s, c->x0, c->y0, c->x1, c->y1, c->r, c->point);
+                break;
+            default:
+                fprintf(stderr, "Unknown draw op: %d\n", c->op);
+                break;
         }
-        OLED_ShowChar(x, y, *p, size, 1);
-        x += size / 2;
-        p++;
     }
 }
 
@@ -300,30 +1224,14 @@ void get_current_time(char *date_str, char *time_str, size_t size1, size_t size2
 }
 
 /**
- * @Description: 获取 CPU 占用率
+ * @Description: 获取 CPU 占用率（采样线程最近一个周期的平均值）
  * @return {*}
  */
 int get_cpu_usage(char *cpu_usage, size_t size) {
-    // 使用mpstat命令获取CPU占用率，popen 打开的文件会将命令的输出保留在一个缓冲区中
-    // mpstat 1 1 表示每秒采样一次，共采样一次
-    // /all/：匹配包含 all 的行，$NF 表示最后一列（即 %idle，CPU 空闲率），head -n 1 限制只输出第一行
-    FILE *fp = popen("mpstat 1 1 | awk '/all/ {print 100 - $NF}' | head -n 1", "r");
-    if (fp == NULL) {
-        perror("Failed to run mpstat command");
-        return -1;
-    }
-    // 读取命令输出
-    char temp[size];
-    if (fgets(temp, size, fp) == NULL) {
-        perror("Failed to read CPU usage");
-        pclose(fp);
+    int usage;
+    if (sampler_latest(SAMPLE_CPU, &usage, 1) < 1)
         return -1;
-    }
-    pclose(fp);
-    // 添加前缀
-    snprintf(cpu_usage, size, "CPU: %.2f%%", atof(temp));
-    // 查找字符串中的换行符并将其替换为终止符 \0，确保字符串没有多余的换行符
-    cpu_usage[strcspn(cpu_usage, "\n")] = '\0';
+    snprintf(cpu_usage, size, "CPU: %d.%02d%%", usage / 100, usage % 100);
     return 0;
 }
 
@@ -332,20 +1240,10 @@ int get_cpu_usage(char *cpu_usage, size_t size) {
  * @return {*}
  */
 int get_cpu_frequency(char *cpu_freq, size_t size) {
-    FILE *file = fopen("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", "r");
-    if (file == NULL) {
-        perror("Failed to open CPU frequency file");
-        return -1;
-    }
-    char line[size];
-    if (fgets(line, size, file) == NULL) {
-        perror("Failed to read CPU frequency");
-        fclose(file);
+    int mhz;
+    if (sampler_latest(SAMPLE_CPU_FREQ, &mhz, 1) < 1)
         return -1;
-    }
-    fclose(file);
-    // 添加前缀
-    snprintf(cpu_freq, size, "CPU: %dMHz", atoi(line) / 1000);
+    snprintf(cpu_freq, size, "CPU: %dMHz", mhz);
     return 0;
 }
 
@@ -354,28 +1252,10 @@ int get_cpu_frequency(char *cpu_freq, size_t size) {
  * @return {*}
  */
 int get_gpu_usage(char *gpu_usage, size_t size) {
-    FILE *file = fopen("/sys/class/devfreq/fb000000.gpu/load", "r");
-    if (file == NULL) {
-        perror("Failed to open GPU load file");
-        return -1;
-    }
-
-    char line[size];
-    if (fgets(line, size, file) == NULL) {
-        perror("Failed to read GPU load");
-        fclose(file);
+    int load;
+    if (sampler_latest(SAMPLE_GPU, &load, 1) < 1)
         return -1;
-    }
-    fclose(file);
-    // 提取@前的数字
-    char *at_pos = strchr(line, '@');
-    if (at_pos == NULL) {
-        fprintf(stderr, "Invalid GPU load format\n");
-        return -1;
-    }
-    *at_pos = '\0'; // 截断字符串，保留@前的部分
-    // 添加前缀
-    snprintf(gpu_usage, size, "GPU: %d%%", atoi(line));
+    snprintf(gpu_usage, size, "GPU: %d%%", load);
     return 0;
 }
 
@@ -384,52 +1264,15 @@ int get_gpu_usage(char *gpu_usage, size_t size) {
  * @return {*}
  */
 int get_npu_usage(char *npu_usage, size_t size) {
-    FILE *file = fopen("/sys/kernel/debug/rknpu/load", "r");
-    if (file == NULL) {
-        perror("Failed to open NPU load file");
-        return -1;
-    }
-    // 读取文件内容
-    char line[size];
-    if (fgets(line, size, file) == NULL) {
-        perror("Failed to read NPU load file");
-        fclose(file);
+    int loads[SAMPLER_NPU_CORES];
+    int n = sampler_latest(SAMPLE_NPU, loads, SAMPLER_NPU_CORES);
+    int len;
+
+    if (n < 0)
         return -1;
-    }
-    fclose(file);
-    // 添加前缀
-    snprintf(npu_usage, size, "NPU: ");
-    // 使用 strchr 查找 % 并提取数字
-    char *ptr = line;
-    int core_count = 0;
-    while ((ptr = strchr(ptr, '%')) != NULL) {
-        char *num_start = ptr - 1;
-        // 回溯直到找到数字的起始位置
-        while (num_start >= line && isdigit(*(num_start - 1))) {
-            num_start--;
-        }
-        // 提取数字，atoi 会从给定的字符串起始位置开始解析，直到遇到第一个非数字字符为止（%前的所有数字）
-        if (isdigit(*num_start)) {
-            int value = atoi(num_start);
-            if (value >= 0 && value <= 100) {
-                // 将数字追加到结果字符串中
-                char buffer[4]; // 最多三位数字
-                snprintf(buffer, sizeof(buffer), "%d%%", value);
-                strcat(npu_usage, buffer);
-                if (core_count >= 0 && core_count < 2) {
-                    strcat(npu_usage, " "); // 添加空格分隔
-                }
-                core_count++;
-            } else {
-                // 如果数字不在 0-100 范围内，跳过
-                fprintf(stderr, "Invalid NPU load value: %d (must be 0-100)\n", value);
-            }
-        } else {
-            // 如果 num_start 指向的位置不是数字字符，跳过
-            fprintf(stderr, "Invalid NPU load format: expected a number before %%\n");
-        }
-        ptr++; // 继续查找下一个 %
-    }
+    len = snprintf(npu_usage, size, "NPU:");
+    for (int i = 0; i < n && len < (int)size; i++)
+        len += snprintf(npu_usage + len, size - len, " %d%%", loads[i]);
     return 0;
 }
 
@@ -438,120 +1281,438 @@ int get_npu_usage(char *npu_usage, size_t size) {
  * @return {*}
  */
 int get_temperature(char *temperature, size_t size) {
-    // 使用sensors命令获取温度
-    FILE *fp = popen("sensors | awk '/temp1/ {print $2}' | head -n 1", "r");
-    if (fp == NULL) {
-        perror("Failed to run sensors command");
-        return -1;
-    }
-    // 读取命令输出
-    char line[size];
-    if (fgets(line, size, fp) == NULL) {
-        perror("Failed to read chip temperature");
-        pclose(fp);
+    int mc;
+    if (sampler_latest(SAMPLE_TEMP, &mc, 1) < 1)
         return -1;
-    }
-    pclose(fp);
-    // 添加前缀
-    snprintf(temperature, size, "Temper: %s", line);
-    // 去掉换行符
-    temperature[strcspn(temperature, "\n")] = '\0';
+    snprintf(temperature, size, "Temper: %.1fC", mc / 1000.0);
     return 0;
 }
 
 /***************************** UI 界面 ******************************/
 
+/* 界面控件，只重绘内容变化的部分 */
+static Widget style_1_widgets[] = {
+    WIDGET_LABEL_INIT(0, 30, FONT_12),  // 日期
+    WIDGET_LABEL_INIT(0, 40, FONT_24),  // 时间
+    WIDGET_LABEL_INIT(0, 8, FONT_16),   // 自定义文本（--text）
+};
+
+static Widget style_2_widgets[] = {
+    WIDGET_LABEL_INIT(0, 0, FONT_16),   // CPU
+    WIDGET_LABEL_INIT(0, 16, FONT_16),  // GPU
+    WIDGET_LABEL_INIT(0, 32, FONT_16),  // NPU
+    WIDGET_LABEL_INIT(0, 48, FONT_16),  // 温度
+};
+
+/* 每行 16 像素：左边是最新值，右边是 96 列的滚动图表 */
+static Widget style_3_widgets[] = {
+    WIDGET_LABEL_INIT(0, 2, FONT_12),
+    WIDGET_GRAPH_INIT(WIDGET_SPARKLINE, 32, 1, 96, 14, SAMPLE_CPU, 0, 10000),
+    WIDGET_LABEL_INIT(0, 18, FONT_12),
+    WIDGET_GRAPH_INIT(WIDGET_BARGRAPH, 32, 17, 96, 14, SAMPLE_GPU, 0, 100),
+    WIDGET_LABEL_INIT(0, 34, FONT_12),
+    WIDGET_GRAPH_INIT(WIDGET_BARGRAPH, 32, 33, 96, 14, SAMPLE_NPU, 0, 100),
+    WIDGET_LABEL_INIT(0, 50, FONT_12),
+    WIDGET_GRAPH_INIT(WIDGET_SPARKLINE, 32, 49, 96, 14, SAMPLE_TEMP, 30000, 90000),
+};
+
+/* 竖屏（旋转 90/270 度）布局，64 x 128，控件顺序与横屏相同 */
+static Widget style_1_portrait[] = {
+    WIDGET_LABEL_INIT(2, 48, FONT_12),  // 日期
+    WIDGET_LABEL_INIT(0, 64, FONT_16),  // 时间
+    WIDGET_LABEL_INIT(2, 24, FONT_12),  // 自定义文本（--text）
+};
+
+static Widget style_2_portrait[] = {
+    WIDGET_LABEL_INIT(0, 10, FONT_12),  // CPU
+    WIDGET_LABEL_INIT(0, 42, FONT_12),  // GPU
+    WIDGET_LABEL_INIT(0, 74, FONT_12),  // NPU
+    WIDGET_LABEL_INIT(0, 106, FONT_12), // 温度
+};
+
+/* 每组 32 像素：上面是最新值，下面是 64 列的滚动图表 */
+static Widget style_3_portrait[] = {
+    WIDGET_LABEL_INIT(0, 1, FONT_12),
+    WIDGET_GRAPH_INIT(WIDGET_SPARKLINE, 0, 14, 64, 17, SAMPLE_CPU, 0, 10000),
+    WIDGET_LABEL_INIT(0, 33, FONT_12),
+    WIDGET_GRAPH_INIT(WIDGET_BARGRAPH, 0, 46, 64, 17, SAMPLE_GPU, 0, 100),
+    WIDGET_LABEL_INIT(0, 65, FONT_12),
+    WIDGET_GRAPH_INIT(WIDGET_BARGRAPH, 0, 78, 64, 17, SAMPLE_NPU, 0, 100),
+    WIDGET_LABEL_INIT(0, 97, FONT_12),
+    WIDGET_GRAPH_INIT(WIDGET_SPARKLINE, 0, 110, 64, 17, SAMPLE_TEMP, 30000, 90000),
+};
+
+#define WIDGET_COUNT(w) ((int)(sizeof(w) / sizeof((w)[0])))
+#define LAYOUT(w) { w, WIDGET_COUNT(w) }
+
+/* 界面布局 */
+typedef struct {
+    Widget *widgets;
+    int count;
+} Layout;
+
+static const Layout landscape_layouts[PAGE_COUNT] = {
+    LAYOUT(style_1_widgets), LAYOUT(style_2_widgets), LAYOUT(style_3_widgets),
+};
+static const Layout portrait_layouts[PAGE_COUNT] = {
+    LAYOUT(style_1_portrait), LAYOUT(style_2_portrait), LAYOUT(style_3_portrait),
+};
+static const Layout *layouts = landscape_layouts;
+
+/* 界面 1 显示的自定义文本 */
+static char display_text[WIDGET_TEXT_MAX];
+/* 提示框文本，空字符串表示没有提示 */
+static char alert_text[WIDGET_TEXT_MAX];
+/* 提示框出现或消失后需要重新合成一帧 */
+static int overlay_changed;
+
 /**
- * @Description: 时间屏保
+ * @Description: 设置界面 1 显示的自定义文本，下一帧生效
+ * @param {const char} *text: 文本
  * @return {*}
  */
-void display_style_1(void) {
+void display_set_text(const char *text)
+{
+    snprintf(display_text, sizeof(display_text), "%s", text ? text : "");
+    widget_set_text(&layouts[0].widgets[2], display_text);
+}
+
+/**
+ * @Description: 在当前界面上显示提示框，下一帧生效
+ * @param {const char} *text: 提示文本，NULL 或空字符串关闭提示框
+ * @return {*}
+ */
+void display_set_alert(const char *text)
+{
+    snprintf(alert_text, sizeof(alert_text), "%s", text ? text : "");
+    overlay_changed = 1;
+}
+
+/**
+ * @Description: 时间和自定义文本（界面 1），每秒整秒时更新
+ * @param {void} *arg: 未使用
+ * @return {*} 1 内容变化，0 没有变化
+ */
+static int update_clock(void *arg) {
     char date_str[20];
     char time_str[20];
+    int changed;
+
+    (void)arg;
     // 获取当前时间
     get_current_time(date_str, time_str, sizeof(date_str), sizeof(time_str));
-    OLED_ShowString(0, 30, (uint8_t *)date_str, FONT_12);
-    OLED_ShowString(0, 40, (uint8_t *)time_str, FONT_24);
+    changed = widget_set_text(&layouts[0].widgets[0], date_str);
+    changed |= widget_set_text(&layouts[0].widgets[1], time_str);
+    changed |= widget_set_text(&layouts[0].widgets[2], display_text);
+    return changed;
+}
+
+/* 界面 2 每行的格式化函数 */
+static const struct {
+    const char *name;
+    int (*format)(char *buf, size_t size);
+} hw_rows[] = {
+    { "CPU usage",        get_cpu_usage },
+    { "GPU usage",        get_gpu_usage },
+    { "NPU usage",        get_npu_usage },
+    { "chip temperature", get_temperature },
+};
+
+/**
+ * @Description: 硬件占用率（界面 2）的一行，按数据来源的采样周期更新
+ * @param {void} *arg: 行号
+ * @return {*} 1 内容变化，0 没有变化
+ */
+static int update_hw_row(void *arg) {
+    int row = (int)(long)arg;
+    char text[WIDGET_TEXT_MAX] = {0};
+
+    if (hw_rows[row].format(text, sizeof(text)) != 0)
+        printf("Failed to get %s\n", hw_rows[row].name);
+    return widget_set_text(&layouts[1].widgets[row], text);
+}
+
+/**
+ * @Description: 采样历史图表（界面 3）的一行：左侧最新值，右侧图表在采样历史有新数据时滚动
+ * @param {void} *arg: 行号
+ * @return {*} 1 内容变化，0 没有变化
+ */
+static int update_history_row(void *arg) {
+    static const struct {
+        int source;
+        const char *format;     // 最新值的显示格式
+        int scale;              // 采样值换算为显示值
+    } rows[] = {
+        { SAMPLE_CPU,  "C%3d%%", 100 },
+        { SAMPLE_GPU,  "G%3d%%", 1 },
+        { SAMPLE_NPU,  "N%3d%%", 1 },
+        { SAMPLE_TEMP, "T%3dC",  1000 },
+    };
+    int row = (int)(long)arg;
+    const Widget *graph = &layouts[2].widgets[row * 2 + 1];
+    int values[SAMPLER_VALUES_MAX], n, sum = 0, changed;
+    char text[WIDGET_TEXT_MAX];
+
+    n = sampler_latest(rows[row].source, values, SAMPLER_VALUES_MAX);
+    for (int k = 0; k < n; k++)
+        sum += values[k];
+    if (n > 0)
+        snprintf(text, sizeof(text), rows[row].format, sum / n / rows[row].scale);
+    else
+        snprintf(text, sizeof(text), "%c  --", rows[row].format[0]);
+    changed = widget_set_text(&layouts[2].widgets[row * 2], text);
+    changed |= atomic_load_explicit(&sampler_history(graph->source)->head, memory_order_acquire) != graph->drawn;
+    return changed;
 }
 
+/***************************** 刷新调度 ******************************/
+
+/* 界面数据项，只有当前界面的项参与调度 */
+typedef struct {
+    const char *name;
+    int page;               // 所属界面
+    int source;             // 数据来源，周期与采样周期相同（更快更新也不会有新数据），-1 使用 period_ms
+    int period_ms;          // 周期
+    int cost_us;            // 预计耗时
+    int flags;              // 调度项标志
+    SchedFunc update;       // 更新控件内容，不绘制
+    int arg;                // 行号
+    int id;                 // 调度器中的编号
+} PageItem;
+
+static PageItem page_items[] = {
+    { "clock",     1, -1,          1000, 20, SCHED_ALIGN, update_clock,       0 },
+    { "cpu",       2, SAMPLE_CPU,  0,    10, 0,           update_hw_row,      0 },
+    { "gpu",       2, SAMPLE_GPU,  0,    10, 0,           update_hw_row,      1 },
+    { "npu",       2, SAMPLE_NPU,  0,    10, 0,           update_hw_row,      2 },
+    { "temp",      2, SAMPLE_TEMP, 0,    10, 0,           update_hw_row,      3 },
+    { "cpu graph", 3, SAMPLE_CPU,  0,    10, 0,           update_history_row, 0 },
+    { "gpu graph", 3, SAMPLE_GPU,  0,    10, 0,           update_history_row, 1 },
+    { "npu graph", 3, SAMPLE_NPU,  0,    10, 0,           update_history_row, 2 },
+    { "tmp graph", 3, SAMPLE_TEMP, 0,    10, 0,           update_history_row, 3 },
+};
+
+#define PAGE_ITEM_COUNT ((int)(sizeof(page_items) / sizeof(page_items[0])))
+
 /**
- * @Description: 硬件占用率
+ * @Description: 切换调度的界面：启用该界面的数据项，停用其他界面的，并立即更新一次该界面的内容
+ *               第一次调用时把所有数据项加入调度器；切换界面（包括切换动画）之前调用
+ * @param {int} page: 界面编号
  * @return {*}
  */
-void display_style_2(void) {
-    // 初始化缓冲区
-    char cpu_usage[20] = {0}; // 过滤后的值长度最大为 6 （100.00）
-    char cpu_freq[20] = {0};
-    char gpu_usage[20] = {0}; // 指令返回的字符串长度为 16
-    char npu_usage[50] = {0}; // 指令返回的字符串长度为 45
-    char temperature[20] = {0};
-    int ret;
+void display_schedule(int page) {
+    static int registered;
 
-    // 获取CPU占用率
-    ret = get_cpu_usage(cpu_usage, sizeof(cpu_usage));
-    if (ret != 0) {
-        printf("Failed to get CPU usage\n");
-    }
-    // 获取CPU频率
-    // ret = get_cpu_frequency(cpu_freq, sizeof(cpu_freq));
-    // if (ret != 0) {
-    //     printf("Failed to get CPU frequency\n");
-    // }
-    // 获取GPU占用率
-    ret = get_gpu_usage(gpu_usage, sizeof(gpu_usage));
-    if (ret != 0) {
-        printf("Failed to get GPU usage\n");
-    }
-    // 获取NPU占用率
-    ret = get_npu_usage(npu_usage, sizeof(npu_usage));
-    if (ret != 0) {
-        printf("Failed to get NPU usage\n");
+    if (!registered) {
+        for (int i = 0; i < PAGE_ITEM_COUNT; i++) {
+            PageItem *it = &page_items[i];
+            int period = it->source >= 0 ? sampler_period(it->source) : it->period_ms;
+
+            it->id = sched_add(it->name, period, it->cost_us, it->flags, it->update, (void *)(long)it->arg);
+        }
+        registered = 1;
     }
-    // 获取芯片温度
-    ret = get_temperature(temperature, sizeof(temperature));
-    if (ret != 0) {
-        printf("Failed to get chip temperature\n");
+    for (int i = 0; i < PAGE_ITEM_COUNT; i++) {
+        PageItem *it = &page_items[i];
+
+        sched_enable(it->id, it->page == page);
+        if (it->page == page)
+            it->update((void *)(long)it->arg);
     }
+}
+
 
-    // 显示
-    OLED_ShowString(0, 0, (uint8_t *)cpu_usage, FONT_16);
-    // OLED_ShowString(64, 0, (uint8_t *)cpu_freq, FONT_16);
-    OLED_ShowString(0, 16, (uint8_t *)gpu_usage, FONT_16);
-    OLED_ShowString(0, 32, (uint8_t *)npu_usage, FONT_16);
-    OLED_ShowString(0, 48, (uint8_t *)temperature, FONT_16);
+/***************************** 选择菜单 ******************************/
+
+/* 每个界面的离屏缓冲，控件记住的内容对应自己的缓冲，切换界面不需要重绘 */
+static uint8_t page_buffers[PAGE_COUNT][FRAME_BUFFER_SIZE];
+/* 旋转 90/270 度时界面转置后的横屏画面，只转置变化的 8x8 块 */
+static uint8_t rotated_buffers[PAGE_COUNT][FRAME_BUFFER_SIZE];
+/* 界面画布，旋转 90/270 度时为竖屏 64 x 128 */
+static Surface page_surfaces[PAGE_COUNT] = {
+    { page_buffers[0], FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH },
+    { page_buffers[1], FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH },
+    { page_buffers[2], FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH },
+};
 
+/**
+ * @Description: 设置软件旋转，90/270 度时界面使用竖屏布局，0/180 度与镜像由驱动的 IOCTL_OLED_SET_ORIENTATION 完成
+ *               需在第一次绘制界面之前调用
+ * @param {int} degrees: 0、90 或 270
+ * @return {*} 0 成功，-1 角度不支持
+ */
+int OLED_SetRotation(int degrees)
+{
+    if (degrees != 0 && degrees != 90 && degrees != 270)
+        return -1;
+    rotation = degrees;
+    layouts = degrees ? portrait_layouts : landscape_layouts;
+    for (int i = 0; i < PAGE_COUNT; i++) {
+        if (degrees)
+            surface_init(&page_surfaces[i], page_buffers[i], FRAME_HEIGHT, FRAME_WIDTH, FRAME_HEIGHT);
+        else
+            surface_init(&page_surfaces[i], page_buffers[i], FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH);
+    }
+    return 0;
 }
 
-void display_style_3(void) {
-    printf("Displaying Style 3: Animated Graphics\n");
+/**
+ * @Description: 把竖屏画布中变化的区域转置到横屏画面，脏矩形同时换算为横屏坐标
+ *               竖屏第 p 页第 k 个 8 列块对应横屏的一个 8x8 块，每块一次 64 位转置
+ *               90 度：横屏 (127 - y, x)；270 度：横屏 (y, 63 - x)
+ * @param {const Surface} *src: 竖屏画布（64 列 x 16 页）
+ * @param {uint8_t} *dst: 横屏画面
+ * @param {Rect} *damage: 竖屏中的脏矩形，返回时为横屏中的脏矩形
+ * @param {int} count: 脏矩形个数
+ * @return {*}
+ */
+static void rotate_damage(const Surface *src, uint8_t *dst, Rect *damage, int count)
+{
+    for (int i = 0; i < count; i++) {
+        Rect *r = &damage[i];
+        int k0 = r->x0 / 8, k1 = r->x1 / 8, p0 = r->y0 / 8, p1 = r->y1 / 8;
+
+        for (int p = p0; p <= p1; p++) {
+            for (int k = k0; k <= k1; k++) {
+                uint64_t x;
+
+                // 小端序：第 j 列为第 j 字节
+                memcpy(&x, src->data + p * src->stride + k * 8, 8);
+                if (rotation == 90) {
+                    // 竖屏第 p 页变为横屏最右边起的第 p 个 8 列块，列的顺序相反
+                    x = __builtin_bswap64(pixconv_transpose8x8(x));
+                    memcpy(dst + k * FRAME_WIDTH + FRAME_WIDTH - 8 - p * 8, &x, 8);
+                } else {
+                    // 竖屏左边的列到横屏的下面，行的顺序相反
+                    x = pixconv_transpose8x8(__builtin_bswap64(x));
+                    memcpy(dst + (FRAME_HEIGHT / 8 - 1 - k) * FRAME_WIDTH + p * 8, &x, 8);
+                }
+            }
+        }
+        if (rotation == 90)
+            *r = (Rect){ FRAME_WIDTH - 8 - p1 * 8, k0 * 8, FRAME_WIDTH - 1 - p0 * 8, k1 * 8 + 7 };
+        else
+            *r = (Rect){ p0 * 8, FRAME_HEIGHT - 8 - k1 * 8, p1 * 8 + 7, FRAME_HEIGHT - 1 - k0 * 8 };
+    }
 }
 
+/**
+ * @Description: 在界面自己的离屏缓冲中更新界面，只重绘变化的控件
+ * @param {int} page: 界面编号
+ * @param {Rect} *damage: 输出离屏画面中变化的区域（帧缓冲坐标）
+ * @param {int} max_damage: 脏矩形数组大小
+ * @param {int} *count: 输出脏矩形个数
+ * @return {*} 与帧缓冲布局相同的离屏画面（旋转 90/270 度时为转置后的画面），界面不存在时返回 NULL
+ */
+const uint8_t *display_page(int page, Rect *damage, int max_damage, int *count) {
+    if (page < 1 || page > PAGE_COUNT) {
+        printf("Invalid page number\n");
+        *count = 0;
+        return NULL;
+    }
+    Surface *s = &page_surfaces[page - 1];
+
+    // 控件内容由调度器按各自的周期更新，这里只重绘变化的控件
+    *count = widget_render(s, layouts[page - 1].widgets, layouts[page - 1].count, damage, max_damage);
+    if (rotation) {
+        rotate_damage(s, rotated_buffers[page - 1], damage, *count);
+        return rotated_buffers[page - 1];
+    }
+    return page_buffers[page - 1];
+}
 
-/***************************** 选择菜单 ******************************/
 /**
- * @Description: 根据用户选择显示不同的界面
- * @param {char} *buffer: 缓冲区
- * @param {size_t} size: 缓冲区大小
+ * @Description: 在画面中间画提示框，文本先画到单独的离屏缓冲中，超出提示框的部分被裁掉
+ * @param {Surface} *s: 绘制目标（界面画面的副本）
  * @return {*}
  */
-void display_ui(int page, char *frame_buffer, size_t frame_size) {
-    /* 保存参数 */
-    buffer = frame_buffer;
-    size = frame_size;
+static void draw_alert(Surface *s)
+{
+    uint8_t text_data[(FONT_12 + 7) / 8 * 255] = { 0 };
+    Surface text;
+    int tw = OLED_StringWidth((const uint8_t *)alert_text, FONT_12);
+    int w, h = FONT_12 + 10, x, y;
 
-    OLED_Clear(); // 清空屏幕缓冲
-    switch (page) {
-        case 1:
-            display_style_1();
-            break;
-        case 2:
-            display_style_2();
-            break;
-        case 3:
-            display_style_3();
-            break;
-        default:
-            printf("Invalid page number\n");
-            break;
+    if (tw > 255)
+        tw = 255;
+    w = tw + 12 > s->width - 4 ? s->width - 4 : tw + 12;
+    x = (s->width - w) / 2;
+    y = (s->height - h) / 2;
+
+    // 文本宽度就是画布宽度，不会换行
+    surface_init(&text, text_data, tw > 0 ? tw : 1, FONT_12, 255);
+    OLED_ShowString(&text, 0, 0, (const uint8_t *)alert_text, FONT_12);
+
+    OLED_FillRoundRect(s, x, y, x + w - 1, y + h - 1, 3, 0);
+    OLED_DrawRoundRect(s, x, y, x + w - 1, y + h - 1, 3, 1);
+    surface_blit(s, x + 6, y + 5, &text, 0, 0, w - 12, FONT_12, ROP_COPY, NULL);
+}
+
+/**
+ * @Description: 生成界面的一帧（帧缓冲布局，包含提示框），只重绘变化的控件
+ * @param {int} page: 界面编号
+ * @param {Rect} *damage: 输出与上一帧相比变化的区域
+ * @param {int} max_damage: 脏矩形数组大小，至少为 1
+ * @param {int} *count: 输出脏矩形个数
+ * @return {*} 画面，在下一次调用之前有效，NULL 表示界面编号无效
+ */
+const uint8_t *display_frame(int page, Rect *damage, int max_damage, int *count) {
+    static int last_page = -1;
+    static uint8_t alert_canvas[FRAME_BUFFER_SIZE], alert_frame[FRAME_BUFFER_SIZE];
+    const uint8_t *src = display_page(page, damage, max_damage, count);
+
+    if (!src)
+        return NULL;
+
+    // 切换界面（或切换动画之后）、提示框出现或消失时按整屏处理，由调用者按实际差异刷新
+    if (page != last_page || overlay_changed) {
+        damage[0] = (Rect){ 0, 0, FRAME_WIDTH - 1, FRAME_HEIGHT - 1 };
+        *count = 1;
     }
+    last_page = page;
+    overlay_changed = 0;
+
+    // 提示框画在界面画面的副本上，界面自己的离屏缓冲不受影响，提示消失后按差异恢复
+    if (alert_text[0]) {
+        if (*count > 0) {
+            const Surface *s = &page_surfaces[page - 1];
+            Surface canvas;
+            Rect all = { 0, 0, s->width - 1, s->height - 1 };
+
+            surface_init(&canvas, alert_canvas, s->width, s->height, s->stride);
+            memcpy(alert_canvas, s->data, FRAME_BUFFER_SIZE);
+            draw_alert(&canvas);
+            if (rotation)
+                rotate_damage(&canvas, alert_frame, &all, 1);
+        }
+        // 界面没有变化时上一次合成的画面仍然有效
+        src = rotation ? alert_frame : alert_canvas;
+    }
+    return src;
+}
+
+/**
+ * @Description: 根据用户选择显示不同的界面，只重绘变化的控件，把变化的区域复制到帧缓冲
+ * @param {int} page: 界面编号
+ * @param {char} *frame_buffer: 缓冲区
+ * @param {size_t} frame_size: 缓冲区大小
+ * @param {Rect} *damage: 输出需要刷新到屏幕的脏矩形
+ * @param {int} max_damage: 脏矩形数组大小
+ * @return {*} 脏矩形个数，0 表示屏幕内容没有变化
+ */
+int display_ui(int page, char *frame_buffer, size_t frame_size, Rect *damage, int max_damage) {
+    Surface fb, view;
+    const uint8_t *src;
+    int count;
+
+    if (frame_size < FRAME_BUFFER_SIZE)
+        return 0;
+    src = display_frame(page, damage, max_damage, &count);
+    if (!src || count == 0)
+        return 0;
+
+    // 离屏画面与帧缓冲比较，每页只复制变化的字节
+    surface_init(&fb, (uint8_t *)frame_buffer, FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH);
+    surface_init(&view, (uint8_t *)src, FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH);
+    return surface_publish(&fb, &view, damage, max_damage);
 }
@@ -12,6 +12,11 @@
 #include <getopt.h>
 
 #include "parse_config.h"
+#include "transition.h"
+#include "page.h"
+#include "control.h"
+#include "server.h"
+#include "pixconv.h"
 
 /**
  * @Description: 显示帮助信息
@@ -21,10 +26,20 @@
 void print_help(const char *program_name) {
     printf("Usage: %s [options]\n", program_name);
     printf("Options:\n");
-    printf("  -o, --oled_pins <scl,mosi,res,dc> Set oled pin number\n");
+    printf("  -o, --oled_pins <scl,mosi,res,dc> Set oled pin number (omit if the driver has set up the panel)\n");
     printf("  -p, --page <number>               Set display page (1, 2, or 3)\n");
-    printf("  -i, --interval <seconds>          Set update interval (default: 1)\n");
+    printf("  -i, --interval <ms>               Minimum update interval (default: 0, each item uses its own period)\n");
     printf("  -t, --text <string>               Set display text\n");
+    printf("  -f, --font <file.olf>             Load a bitmap font for non-ASCII text (see tools/bdf2olf)\n");
+    printf("  -a, --anim <file.ola>             Play an animation instead of the pages\n");
+    printf("  -c, --carousel <seconds>          Rotate through the pages every <seconds> (default: 0, off)\n");
+    printf("  -T, --transition <type>           Carousel transition: none, slide, wipe, push, fade (default: slide)\n");
+    printf("  -R, --rotate <degrees>            Rotate the display: 0, 90, 180, 270 (default: 0)\n");
+    printf("  -F, --flip <h|v|hv>               Mirror the display horizontally and/or vertically\n");
+    printf("  -S, --socket <path>               Control socket (default: %s)\n", CONTROL_SOCKET_PATH);
+    printf("                                    Commands: page <n>, text <string>, interval <ms>, alert <seconds> [message]\n");
+    printf("  -I, --stdin-format <format>       Show raw 128x64 video frames from stdin: gray8, rgb24, mono, rgb565, rgba\n");
+    printf("  -s, --server                      Share the screen with other processes (socket: %s)\n", SERVER_SOCKET_PATH);
     printf("  -v, --verbose                     Enable verbose output\n");
     printf("  -h, --help                        Show this help message\n");
 }
@@ -38,9 +53,20 @@ void print_config(AppConfig config) {
     printf(" **************************\n");
     printf("Parse Information:\n");
     printf("    Display page: %d\n", config.page);
-    printf("    Update Interval: %d millisecond(ms)\n", config.interval);
+    if (config.interval)
+        printf("    Update Interval: at least %d millisecond(ms)\n", config.interval);
+    else
+        printf("    Update Interval: per item\n");
     printf("    Display Text: %s\n", config.text);
-    printf("    GPIOs: %s\n", config.oled_pins);
+    printf("    Font: %s\n", config.font ? config.font : "(built-in ASCII only)");
+    printf("    Animation: %s\n", config.anim ? config.anim : "(none)");
+    printf("    Carousel: %d s\n", config.carousel);
+    printf("    Rotate: %d, flip: %s%s\n", config.rotate,
+           config.flip & OLED_ORIENT_FLIP_H ? "h" : "", config.flip & OLED_ORIENT_FLIP_V ? "v" : "");
+    printf("    Control socket: %s\n", config.socket);
+    printf("    Stdin video: %s\n", config.stdin_format >= 0 ? "on" : "off");
+    printf("    Display server: %s\n", config.server ? SERVER_SOCKET_PATH : "off");
+    printf("    GPIOs: %s\n", config.oled_pins ? config.oled_pins : "(configured by driver)");
 }
 
 /*
@@ -50,10 +76,19 @@ void print_config(AppConfig config) {
  */
 AppConfig parse_arguments(int argc, char *argv[]) {
     AppConfig config = {
-        .oled_pins = NULL,  // 默认为空字符串，提示用户传入
+        .oled_pins = NULL,  // 默认为空，直接使用驱动已初始化的屏幕
         .page = 1,          // 默认显示风格
-        .interval = 1000,   // 默认更新间隔
+        .interval = 0,      // 默认不限制，各数据项按自己的周期更新
         .text = "SPI OLED", // 默认显示文本
+        .font = NULL,       // 默认不加载外部字库
+        .anim = NULL,       // 默认显示界面
+        .carousel = 0,      // 默认不轮播
+        .transition = TRANSITION_SLIDE,
+        .rotate = 0,        // 默认不旋转
+        .flip = 0,          // 默认不镜像
+        .socket = CONTROL_SOCKET_PATH,
+        .server = 0,        // 默认不接受其他进程的图层
+        .stdin_format = -1, // 默认不读取标准输入
         .verbose = 0        // 默认关闭详细信息
     };
 
@@ -63,6 +98,15 @@ AppConfig parse_arguments(int argc, char *argv[]) {
         {"page",      required_argument, 0, 'p'},
         {"interval",  required_argument, 0, 'i'},
         {"text",      required_argument, 0, 't'},
+        {"font",      required_argument, 0, 'f'},
+        {"anim",      required_argument, 0, 'a'},
+        {"carousel",  required_argument, 0, 'c'},
+        {"transition", required_argument, 0, 'T'},
+        {"rotate",    required_argument, 0, 'R'},
+        {"flip",      required_argument, 0, 'F'},
+        {"socket",    required_argument, 0, 'S'},
+        {"server",    no_argument,       0, 's'},
+        {"stdin-format", required_argument, 0, 'I'},
         {"verbose",   no_argument,       0, 'v'},
         {"help",      no_argument,       0, 'h'},
         {0, 0, 0, 0}
@@ -71,9 +115,9 @@ AppConfig parse_arguments(int argc, char *argv[]) {
     /* 解析参数 */ 
     int opt;
     // 支持短选项和长选项
-    // : 表示该选项需要一个参数，v 和 h 不需要
+    // : 表示该选项需要一个参数，s、v 和 h 不需要
     // 如果解析到长选项，返回 val 字段的值（即第四列）
-    while ((opt = getopt_long(argc, argv, "o:p:i:t:vh", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "o:p:i:t:f:a:c:T:R:F:S:sI:vh", long_options, NULL)) != -1) {
         switch (opt) {
             case 'o':
                 config.oled_pins = optarg;
@@ -95,6 +139,59 @@ AppConfig parse_arguments(int argc, char *argv[]) {
             case 't':
                 config.text = optarg;
                 break;
+            case 'f':
+                config.font = optarg;
+                break;
+            case 'a':
+                config.anim = optarg;
+                break;
+            case 'c':
+                config.carousel = atoi(optarg);
+                if (config.carousel < 0) {
+                    fprintf(stderr, "Carousel interval must not be negative.\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'T':
+                config.transition = transition_parse(optarg);
+                if (config.transition < 0) {
+                    fprintf(stderr, "Unknown transition: %s\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'R':
+                config.rotate = atoi(optarg);
+                if (config.rotate != 0 && config.rotate != 90 && config.rotate != 180 && config.rotate != 270) {
+                    fprintf(stderr, "Invalid rotation. Use 0, 90, 180 or 270.\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'F':
+                config.flip = 0;
+                for (const char *c = optarg; *c; c++) {
+                    if (*c == 'h')
+                        config.flip |= OLED_ORIENT_FLIP_H;
+                    else if (*c == 'v')
+                        config.flip |= OLED_ORIENT_FLIP_V;
+                    else {
+                        fprintf(stderr, "Invalid flip: %s. Use h, v or hv.\n", optarg);
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                break;
+            case 'S':
+                config.socket = optarg;
+                break;
+            case 's':
+                config.server = 1;
+                break;
+            case 'I':
+                config.stdin_format = pixconv_format_parse(optarg);
+                if (config.stdin_format < 0) {
+                    fprintf(stderr, "Unknown stdin format: %s\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
             case 'v':
                 config.verbose = 1;
                 break;
@@ -0,0 +1,700 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 19:30:12
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 20:52:06
+ * @Description: 像素格式转换，把逐行存放的灰度/RGB565/RGB24/RGBA/单色图转换为帧缓冲的页式 1bpp 布局
+ *               页式布局中一个字节是同一列的 8 行，SIMD 一次比较一行 16（AVX2 为 32）列，
+ *               再把 8 行的比较结果按行号的位掩码合并，直接得到帧缓冲字节，不需要逐点转置
+ *               RGB565/RGB24/RGBA 先逐行转换为灰度（SIMD，RGB24 只有 NEON 可以交错加载，x86 使用标量实现），
+ *               单色图每 8x8 块一次 64 位位矩阵转置
+ *               AVX2 在运行时检测，不需要 -mavx2 编译
+ *               make test 在随机输入上比较 SIMD 与标量实现的输出（tests/pixconv_test.c）
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+/* 定义 PIXCONV_NO_AVX2 时不检测 AVX2，x86 上固定使用 SSE2 实现（make test 用它测试 SSE2 路径） */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(PIXCONV_NO_AVX2)
+#include <immintrin.h>
+#define PIXCONV_AVX2 1
+#endif
+
+#include "pixconv.h"
+
+/* 灰度权重（ITU-R BT.601，和为 256） */
+#define LUMA_R 77
+#define LUMA_G 150
+#define LUMA_B 29
+
+/* 8x8 Bayer 矩阵换算成的阈值（0~255） */
+static const uint8_t bayer8[8][8] = {
+    {   2, 130,  34, 162,  10, 138,  42, 170 },
+    { 194,  66, 226,  98, 202,  74, 234, 106 },
+    {  50, 178,  18, 146,  58, 186,  26, 154 },
+    { 242, 114, 210,  82, 250, 122, 218,  90 },
+    {  14, 142,  46, 174,   6, 134,  38, 166 },
+    { 206,  78, 238, 110, 198,  70, 230, 102 },
+    {  62, 190,  30, 158,  54, 182,  22, 150 },
+    { 254, 126, 222,  94, 246, 118, 214,  86 },
+};
+
+/**
+ * @Description: 加入时间稳定滤波后的阈值
+ * @param {int} t: 原阈值
+ * @param {int} was_on: 上一帧该像素是否点亮
+ * @param {int} h: 滞回量
+ * @return {*}
+ */
+static inline int hysteresis_threshold(int t, int was_on, int h) {
+    if (was_on)
+        return t > h ? t - h : 0;
+    return t + h < 255 ? t + h : 255;
+}
+
+/**
+ * @Description: 像素格式名转换为 PixFormat
+ * @param {const char} *name: gray8、rgb565、rgba、mono 或 rgb24
+ * @return {*} PixFormat，未知格式返回 -1
+ */
+int pixconv_format_parse(const char *name) {
+    static const char * const names[PIX_FMT_COUNT] = { "gray8", "rgb565", "rgba", "mono", "rgb24" };
+
+    for (int i = 0; i < PIX_FMT_COUNT; i++)
+        if (strcmp(name, names[i]) == 0)
+            return i;
+    return -1;
+}
+
+/**
+ * @Description: 一行像素的字节数
+ * @param {int} format: PixFormat
+ * @param {int} width: 每行像素数
+ * @return {*}
+ */
+int pixconv_row_bytes(int format, int width) {
+    switch (format) {
+        case PIX_FMT_RGB565:
+            return width * 2;
+        case PIX_FMT_RGB888:
+            return width * 3;
+        case PIX_FMT_RGBA8888:
+            return width * 4;
+        case PIX_FMT_MONO:
+            return (width + 7) / 8;
+        default:
+            return width;
+    }
+}
+
+/**
+ * @Description: 一行中第 x0 ~ n-1 个像素转换为灰度（标量实现，也处理 SIMD 剩下的尾部）
+ * @param {const uint8_t} *row: 一行像素
+ * @param {int} format: PixFormat
+ * @param {int} x0: 起始像素
+ * @param {int} n: 像素个数
+ * @param {uint8_t} *out: 输出灰度
+ * @return {*}
+ */
+static void gray_row_scalar(const uint8_t *row, int format, int x0, int n, uint8_t *out) {
+    for (int x = x0; x < n; x++) {
+        int r, g, b, y;
+
+        switch (format) {
+            case PIX_FMT_RGB565: {
+                int v = row[x * 2] | row[x * 2 + 1] << 8;
+                // 5/6 位扩展到 8 位：高位复制到低位
+                r = v >> 11;
+                g = (v >> 5) & 0x3F;
+                b = v & 0x1F;
+                r = r << 3 | r >> 2;
+                g = g << 2 | g >> 4;
+                b = b << 3 | b >> 2;
+                out[x] = (r * LUMA_R + g * LUMA_G + b * LUMA_B) >> 8;
+                break;
+            }
+            case PIX_FMT_RGB888: {
+                const uint8_t *px = row + x * 3;
+                out[x] = (px[0] * LUMA_R + px[1] * LUMA_G + px[2] * LUMA_B) >> 8;
+                break;
+            }
+            case PIX_FMT_RGBA8888: {
+                const uint8_t *px = row + x * 4;
+                y = (px[0] * LUMA_R + px[1] * LUMA_G + px[2] * LUMA_B) >> 8;
+                out[x] = y * (px[3] + 1) >> 8;
+                break;
+            }
+            case PIX_FMT_MONO:
+                out[x] = row[x / 8] & (0x80 >> (x % 8)) ? 255 : 0;
+                break;
+            default:
+                out[x] = row[x];
+                break;
+        }
+    }
+}
+
+#if defined(__SSE2__)
+/**
+ * @Description: 8 个像素的 R、G、B（16 位，0~255）转换为灰度
+ * @return {*}
+ */
+static inline __m128i luma_sse2(__m128i r, __m128i g, __m128i b) {
+    __m128i y = _mm_mullo_epi16(r, _mm_set1_epi16(LUMA_R));
+
+    y = _mm_add_epi16(y, _mm_mullo_epi16(g, _mm_set1_epi16(LUMA_G)));
+    y = _mm_add_epi16(y, _mm_mullo_epi16(b, _mm_set1_epi16(LUMA_B)));
+    return _mm_srli_epi16(y, 8);   // 最大 255 * 256，16 位不会溢出
+}
+
+/**
+ * @Description: 8 个 RGB565 像素转换为灰度（16 位）
+ * @return {*}
+ */
+static inline __m128i rgb565_luma_sse2(const uint8_t *src) {
+    __m128i v = _mm_loadu_si128((const __m128i *)src);
+    __m128i r = _mm_srli_epi16(v, 11);
+    __m128i g = _mm_and_si128(_mm_srli_epi16(v, 5), _mm_set1_epi16(0x3F));
+    __m128i b = _mm_and_si128(v, _mm_set1_epi16(0x1F));
+
+    r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+    g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+    b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+    return luma_sse2(r, g, b);
+}
+
+/**
+ * @Description: 8 个 RGBA 像素转换为灰度（16 位），alpha 与黑色背景混合
+ * @return {*}
+ */
+static inline __m128i rgba_luma_sse2(const uint8_t *src) {
+    __m128i v0 = _mm_loadu_si128((const __m128i *)src);
+    __m128i v1 = _mm_loadu_si128((const __m128i *)(src + 16));
+    __m128i m = _mm_set1_epi32(0xFF);
+    // 每个通道取出后由 32 位压缩为 16 位（值不超过 255，有符号饱和不影响）
+    __m128i r = _mm_packs_epi32(_mm_and_si128(v0, m), _mm_and_si128(v1, m));
+    __m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(v0, 8), m), _mm_and_si128(_mm_srli_epi32(v1, 8), m));
+    __m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(v0, 16), m), _mm_and_si128(_mm_srli_epi32(v1, 16), m));
+    __m128i a = _mm_packs_epi32(_mm_srli_epi32(v0, 24), _mm_srli_epi32(v1, 24));
+
+    a = _mm_add_epi16(a, _mm_set1_epi16(1));
+    return _mm_srli_epi16(_mm_mullo_epi16(luma_sse2(r, g, b), a), 8);
+}
+
+/**
+ * @Description: 一行 RGB565/RGBA 转换为灰度，每次 16 个像素
+ * @return {*} 已处理的像素个数，剩下的由标量实现处理
+ */
+static int gray_row_simd(const uint8_t *row, int format, int n, uint8_t *out) {
+    int x = 0;
+
+    if (format == PIX_FMT_RGB888)
+        return 0;   // 3 字节的像素没有 SSE2 的解交错指令
+    for (; x + 16 <= n; x += 16) {
+        __m128i lo, hi;
+
+        if (format == PIX_FMT_RGB565) {
+            lo = rgb565_luma_sse2(row + x * 2);
+            hi = rgb565_luma_sse2(row + x * 2 + 16);
+        } else {
+            lo = rgba_luma_sse2(row + x * 4);
+            hi = rgba_luma_sse2(row + x * 4 + 32);
+        }
+        _mm_storeu_si128((__m128i *)(out + x), _mm_packus_epi16(lo, hi));
+    }
+    return x;
+}
+#elif defined(__ARM_NEON)
+/**
+ * @Description: 一行 RGB565/RGB24/RGBA 转换为灰度，每次 16 个像素
+ * @return {*} 已处理的像素个数，剩下的由标量实现处理
+ */
+static int gray_row_simd(const uint8_t *row, int format, int n, uint8_t *out) {
+    int x = 0;
+
+    for (; x + 16 <= n; x += 16) {
+        if (format == PIX_FMT_RGB565) {
+            uint8x8_t half[2];
+
+            for (int k = 0; k < 2; k++) {
+                uint16x8_t v = vld1q_u16((const uint16_t *)(row + x * 2 + k * 16));
+                uint16x8_t r = vshrq_n_u16(v, 11);
+                uint16x8_t g = vandq_u16(vshrq_n_u16(v, 5), vdupq_n_u16(0x3F));
+                uint16x8_t b = vandq_u16(v, vdupq_n_u16(0x1F));
+                uint16x8_t y;
+
+                r = vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2));
+                g = vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4));
+                b = vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2));
+                y = vmulq_n_u16(r, LUMA_R);
+                y = vmlaq_n_u16(y, g, LUMA_G);
+                y = vmlaq_n_u16(y, b, LUMA_B);
+                half[k] = vshrn_n_u16(y, 8);
+            }
+            vst1q_u8(out + x, vcombine_u8(half[0], half[1]));
+        } else if (format == PIX_FMT_RGB888) {
+            uint8x16x3_t px = vld3q_u8(row + x * 3);
+            uint16x8_t lo, hi;
+
+            lo = vmull_u8(vget_low_u8(px.val[0]), vdup_n_u8(LUMA_R));
+            lo = vmlal_u8(lo, vget_low_u8(px.val[1]), vdup_n_u8(LUMA_G));
+            lo = vmlal_u8(lo, vget_low_u8(px.val[2]), vdup_n_u8(LUMA_B));
+            hi = vmull_u8(vget_high_u8(px.val[0]), vdup_n_u8(LUMA_R));
+            hi = vmlal_u8(hi, vget_high_u8(px.val[1]), vdup_n_u8(LUMA_G));
+            hi = vmlal_u8(hi, vget_high_u8(px.val[2]), vdup_n_u8(LUMA_B));
+            vst1q_u8(out + x, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+        } else {
+            // 交错加载直接得到 16 个像素的 R、G、B、A
+            uint8x16x4_t px = vld4q_u8(row + x * 4);
+            uint8x8_t y[2], a[2] = { vget_low_u8(px.val[3]), vget_high_u8(px.val[3]) };
+            uint16x8_t t;
+
+            t = vmull_u8(vget_low_u8(px.val[0]), vdup_n_u8(LUMA_R));
+            t = vmlal_u8(t, vget_low_u8(px.val[1]), vdup_n_u8(LUMA_G));
+            t = vmlal_u8(t, vget_low_u8(px.val[2]), vdup_n_u8(LUMA_B));
+            y[0] = vshrn_n_u16(t, 8);
+            t = vmull_u8(vget_high_u8(px.val[0]), vdup_n_u8(LUMA_R));
+            t = vmlal_u8(t, vget_high_u8(px.val[1]), vdup_n_u8(LUMA_G));
+            t = vmlal_u8(t, vget_high_u8(px.val[2]), vdup_n_u8(LUMA_B));
+            y[1] = vshrn_n_u16(t, 8);
+            // y * (a + 1) >> 8
+            for (int k = 0; k < 2; k++)
+                y[k] = vshrn_n_u16(vaddw_u8(vmull_u8(y[k], a[k]), y[k]), 8);
+            vst1q_u8(out + x, vcombine_u8(y[0], y[1]));
+        }
+    }
+    return x;
+}
+#endif
+
+#ifdef PIXCONV_AVX2
+/**
+ * @Description: 16 个像素的 R、G、B（16 位，0~255）转换为灰度
+ * @return {*}
+ */
+__attribute__((target("avx2")))
+static inline __m256i luma_avx2(__m256i r, __m256i g, __m256i b) {
+    __m256i y = _mm256_mullo_epi16(r, _mm256_set1_epi16(LUMA_R));
+
+    y = _mm256_add_epi16(y, _mm256_mullo_epi16(g, _mm256_set1_epi16(LUMA_G)));
+    y = _mm256_add_epi16(y, _mm256_mullo_epi16(b, _mm256_set1_epi16(LUMA_B)));
+    return _mm256_srli_epi16(y, 8);
+}
+
+/**
+ * @Description: 16 个 RGB565 像素转换为灰度（16 位）
+ * @return {*}
+ */
+__attribute__((target("avx2")))
+static inline __m256i rgb565_luma_avx2(const uint8_t *src) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)src);
+    __m256i r = _mm256_srli_epi16(v, 11);
+    __m256i g = _mm256_and_si256(_mm256_srli_epi16(v, 5), _mm256_set1_epi16(0x3F));
+    __m256i b = _mm256_and_si256(v, _mm256_set1_epi16(0x1F));
+
+    r = _mm256_or_si256(_mm256_slli_epi16(r, 3), _mm256_srli_epi16(r, 2));
+    g = _mm256_or_si256(_mm256_slli_epi16(g, 2), _mm256_srli_epi16(g, 4));
+    b = _mm256_or_si256(_mm256_slli_epi16(b, 3), _mm256_srli_epi16(b, 2));
+    return luma_avx2(r, g, b);
+}
+
+/**
+ * @Description: 16 个 RGBA 像素转换为灰度（16 位），alpha 与黑色背景混合
+ * @return {*}
+ */
+__attribute__((target("avx2")))
+static inline __m256i rgba_luma_avx2(const uint8_t *src) {
+    __m256i v0 = _mm256_loadu_si256((const __m256i *)src);
+    __m256i v1 = _mm256_loadu_si256((const __m256i *)(src + 32));
+    __m256i m = _mm256_set1_epi32(0xFF);
+    __m256i r = _mm256_packs_epi32(_mm256_and_si256(v0, m), _mm256_and_si256(v1, m));
+    __m256i g = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(v0, 8), m),
+                                   _mm256_and_si256(_mm256_srli_epi32(v1, 8), m));
+    __m256i b = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(v0, 16), m),
+                                   _mm256_and_si256(_mm256_srli_epi32(v1, 16), m));
+    __m256i a = _mm256_packs_epi32(_mm256_srli_epi32(v0, 24), _mm256_srli_epi32(v1, 24));
+    __m256i y;
+
+    a = _mm256_add_epi16(a, _mm256_set1_epi16(1));
+    y = _mm256_srli_epi16(_mm256_mullo_epi16(luma_avx2(r, g, b), a), 8);
+    // 压缩在每个 128 位通道内进行，像素顺序为 0~3 8~11 4~7 12~15，恢复顺序
+    return _mm256_permute4x64_epi64(y, 0xD8);
+}
+
+/**
+ * @Description: 一行 RGB565/RGBA 转换为灰度，每次 32 个像素
+ * @return {*} 已处理的像素个数，剩下的由标量实现处理
+ */
+__attribute__((target("avx2")))
+static int gray_row_avx2(const uint8_t *row, int format, int n, uint8_t *out) {
+    int x = 0;
+
+    if (format == PIX_FMT_RGB888)
+        return 0;
+    for (; x + 32 <= n; x += 32) {
+        __m256i lo, hi;
+
+        if (format == PIX_FMT_RGB565) {
+            lo = rgb565_luma_avx2(row + x * 2);
+            hi = rgb565_luma_avx2(row + x * 2 + 32);
+        } else {
+            lo = rgba_luma_avx2(row + x * 4);
+            hi = rgba_luma_avx2(row + x * 4 + 64);
+        }
+        _mm256_storeu_si256((__m256i *)(out + x),
+                            _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8));
+    }
+    return x;
+}
+
+/**
+ * @Description: CPU 是否支持 AVX2（只检测一次）
+ * @return {*}
+ */
+static int have_avx2(void) {
+    static int avx2 = -1;
+
+    if (avx2 < 0)
+        avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    return avx2;
+}
+#endif
+
+/**
+ * @Description: 逐行图像转换为灰度图（有 SIMD 时彩色格式使用 SIMD 实现）
+ * @param {const void} *src: 输入图像
+ * @param {int} stride: 输入每行的字节数
+ * @param {int} format: 输入像素格式 PixFormat
+ * @param {int} width: 宽度
+ * @param {int} height: 高度
+ * @param {uint8_t} *gray: 输出灰度图
+ * @param {int} gray_stride: 输出每行的字节数
+ * @return {*}
+ */
+void pixconv_to_gray(const void *src, int stride, int format, int width, int height, uint8_t *gray, int gray_stride) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = (const uint8_t *)src + (size_t)y * stride;
+        uint8_t *out = gray + (size_t)y * gray_stride;
+        int x = 0;
+
+        if (format == PIX_FMT_GRAY8) {
+            memcpy(out, row, width);
+            continue;
+        }
+        if (format == PIX_FMT_RGB565 || format == PIX_FMT_RGB888 || format == PIX_FMT_RGBA8888) {
+#ifdef PIXCONV_AVX2
+            if (have_avx2())
+                x = gray_row_avx2(row, format, width, out);
+#endif
+#if defined(__SSE2__) || defined(__ARM_NEON)
+            x += gray_row_simd(row + pixconv_row_bytes(format, x), format, width - x, out + x);
+#endif
+        }
+        gray_row_scalar(row, format, x, width, out);
+    }
+}
+
+/**
+ * @Description: 逐行图像转换为灰度图（标量参考实现）
+ * @param {const void} *src: 输入图像
+ * @param {int} stride: 输入每行的字节数
+ * @param {int} format: 输入像素格式 PixFormat
+ * @param {int} width: 宽度
+ * @param {int} height: 高度
+ * @param {uint8_t} *gray: 输出灰度图
+ * @param {int} gray_stride: 输出每行的字节数
+ * @return {*}
+ */
+void pixconv_to_gray_scalar(const void *src, int stride, int format, int width, int height, uint8_t *gray, int gray_stride) {
+    for (int y = 0; y < height; y++)
+        gray_row_scalar((const uint8_t *)src + (size_t)y * stride, format, 0, width, gray + (size_t)y * gray_stride);
+}
+
+/**
+ * @Description: Floyd-Steinberg 误差扩散（逐点依赖，只有标量实现）
+ * @param {const uint8_t} *gray: 灰度图，FRAME_WIDTH x FRAME_HEIGHT
+ * @param {int} stride: 灰度图每行的字节数
+ * @param {uint8_t} *frame: 输出帧缓冲
+ * @param {const uint8_t} *prev: 上一帧输出，NULL 表示不做时间稳定滤波
+ * @param {const PixConfig} *cfg: 转换参数
+ * @return {*}
+ */
+static void floyd_steinberg(const uint8_t *gray, int stride, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg) {
+    // 当前行和下一行的误差，左右各留一个位置免去边界判断
+    short err[2][FRAME_WIDTH + 2];
+    short *cur = err[0], *next = err[1], *t;
+
+    memset(err, 0, sizeof(err));
+    memset(frame, 0, FRAME_BUFFER_SIZE);
+    for (int y = 0; y < FRAME_HEIGHT; y++) {
+        const uint8_t *row = gray + y * stride;
+        uint8_t bit = OLED_PIXEL_MASK(y);
+        uint8_t *out = frame + (y / 8) * FRAME_WIDTH;
+
+        for (int x = 0; x < FRAME_WIDTH; x++) {
+            int v = row[x] + cur[x + 1];
+            int th = cfg->threshold;
+            int e;
+
+            if (prev && cfg->hysteresis)
+                th = hysteresis_threshold(th, prev[(y / 8) * FRAME_WIDTH + x] & bit, cfg->hysteresis);
+            if (v > th) {
+                out[x] |= bit;
+                e = v - 255;
+            } else {
+                e = v;
+            }
+            cur[x + 2] += e * 7 / 16;
+            next[x] += e * 3 / 16;
+            next[x + 1] += e * 5 / 16;
+            next[x + 2] += e / 16;
+        }
+        t = cur;
+        cur = next;
+        next = t;
+        memset(next, 0, sizeof(err[0]));
+    }
+}
+
+/**
+ * @Description: 标量实现（参考实现，也用于没有 SIMD 的平台）
+ * @param {const uint8_t} *gray: 灰度图，FRAME_WIDTH x FRAME_HEIGHT
+ * @param {int} stride: 灰度图每行的字节数
+ * @param {uint8_t} *frame: 输出帧缓冲
+ * @param {const uint8_t} *prev: 上一帧输出，NULL 表示不做时间稳定滤波
+ * @param {const PixConfig} *cfg: 转换参数
+ * @return {*}
+ */
+void pixconv_gray8_scalar(const uint8_t *gray, int stride, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg) {
+    if (cfg->dither == PIX_FLOYD_STEINBERG) {
+        floyd_steinberg(gray, stride, frame, prev, cfg);
+        return;
+    }
+
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        for (int x = 0; x < FRAME_WIDTH; x++) {
+            uint8_t byte = 0;
+            for (int r = 0; r < 8; r++) {
+                int y = p * 8 + r;
+                uint8_t bit = OLED_PIXEL_MASK(y);
+                int th = cfg->dither == PIX_ORDERED ? bayer8[r][x % 8] : cfg->threshold;
+
+                if (prev && cfg->hysteresis)
+                    th = hysteresis_threshold(th, prev[p * FRAME_WIDTH + x] & bit, cfg->hysteresis);
+                if (gray[y * stride + x] > th)
+                    byte |= bit;
+            }
+            frame[p * FRAME_WIDTH + x] = byte;
+        }
+    }
+}
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+/**
+ * @Description: 阈值和有序抖动的 SIMD 实现，每次处理一页中的 16 列
+ * @param {const uint8_t} *gray: 灰度图，FRAME_WIDTH x FRAME_HEIGHT
+ * @param {int} stride: 灰度图每行的字节数
+ * @param {uint8_t} *frame: 输出帧缓冲
+ * @param {const uint8_t} *prev: 上一帧输出，NULL 表示不做时间稳定滤波
+ * @param {const PixConfig} *cfg: 转换参数
+ * @return {*}
+ */
+static void pixconv_gray8_simd(const uint8_t *gray, int stride, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg) {
+    uint8_t th[8][16];
+    int filter = prev && cfg->hysteresis;
+
+    // 每行的阈值，Bayer 矩阵一行 8 个，重复两次凑成 16 列
+    for (int r = 0; r < 8; r++)
+        for (int c = 0; c < 16; c++)
+            th[r][c] = cfg->dither == PIX_ORDERED ? bayer8[r][c % 8] : cfg->threshold;
+
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        for (int x = 0; x < FRAME_WIDTH; x += 16) {
+            const uint8_t *src = gray + p * 8 * stride + x;
+#if defined(__SSE2__)
+            __m128i acc = _mm_setzero_si128();
+            __m128i h = _mm_set1_epi8(cfg->hysteresis);
+            __m128i old = filter ? _mm_loadu_si128((const __m128i *)(prev + p * FRAME_WIDTH + x)) : acc;
+
+            for (int r = 0; r < 8; r++, src += stride) {
+                __m128i bit = _mm_set1_epi8((char)OLED_PIXEL_MASK(r));
+                __m128i t = _mm_loadu_si128((const __m128i *)th[r]);
+                __m128i g = _mm_loadu_si128((const __m128i *)src);
+                __m128i off;
+
+                if (filter) {
+                    __m128i was_on = _mm_cmpeq_epi8(_mm_and_si128(old, bit), bit);
+                    t = _mm_or_si128(_mm_and_si128(was_on, _mm_subs_epu8(t, h)),
+                                     _mm_andnot_si128(was_on, _mm_adds_epu8(t, h)));
+                }
+                // 无符号比较：g > t 等价于 g - t（饱和）不为 0
+                off = _mm_cmpeq_epi8(_mm_subs_epu8(g, t), _mm_setzero_si128());
+                acc = _mm_or_si128(acc, _mm_andnot_si128(off, bit));
+            }
+            _mm_storeu_si128((__m128i *)(frame + p * FRAME_WIDTH + x), acc);
+#else
+            uint8x16_t acc = vdupq_n_u8(0);
+            uint8x16_t h = vdupq_n_u8(cfg->hysteresis);
+            uint8x16_t old = filter ? vld1q_u8(prev + p * FRAME_WIDTH + x) : acc;
+
+            for (int r = 0; r < 8; r++, src += stride) {
+                uint8x16_t bit = vdupq_n_u8(OLED_PIXEL_MASK(r));
+                uint8x16_t t = vld1q_u8(th[r]);
+
+                if (filter)
+                    t = vbslq_u8(vtstq_u8(old, bit), vqsubq_u8(t, h), vqaddq_u8(t, h));
+                acc = vorrq_u8(acc, vandq_u8(vcgtq_u8(vld1q_u8(src), t), bit));
+            }
+            vst1q_u8(frame + p * FRAME_WIDTH + x, acc);
+#endif
+        }
+    }
+}
+#endif
+
+#ifdef PIXCONV_AVX2
+/**
+ * @Description: 阈值和有序抖动的 AVX2 实现，每次处理一页中的 32 列
+ * @param {const uint8_t} *gray: 灰度图，FRAME_WIDTH x FRAME_HEIGHT
+ * @param {int} stride: 灰度图每行的字节数
+ * @param {uint8_t} *frame: 输出帧缓冲
+ * @param {const uint8_t} *prev: 上一帧输出，NULL 表示不做时间稳定滤波
+ * @param {const PixConfig} *cfg: 转换参数
+ * @return {*}
+ */
+__attribute__((target("avx2")))
+static void pixconv_gray8_avx2(const uint8_t *gray, int stride, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg) {
+    uint8_t th[8][32];
+    int filter = prev && cfg->hysteresis;
+    __m256i zero = _mm256_setzero_si256();
+    __m256i h = _mm256_set1_epi8(cfg->hysteresis);
+
+    for (int r = 0; r < 8; r++)
+        for (int c = 0; c < 32; c++)
+            th[r][c] = cfg->dither == PIX_ORDERED ? bayer8[r][c % 8] : cfg->threshold;
+
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        for (int x = 0; x < FRAME_WIDTH; x += 32) {
+            const uint8_t *src = gray + p * 8 * stride + x;
+            __m256i acc = zero;
+            __m256i old = filter ? _mm256_loadu_si256((const __m256i *)(prev + p * FRAME_WIDTH + x)) : zero;
+
+            for (int r = 0; r < 8; r++, src += stride) {
+                __m256i bit = _mm256_set1_epi8((char)OLED_PIXEL_MASK(r));
+                __m256i t = _mm256_loadu_si256((const __m256i *)th[r]);
+                __m256i g = _mm256_loadu_si256((const __m256i *)src);
+
+                if (filter) {
+                    __m256i was_on = _mm256_cmpeq_epi8(_mm256_and_si256(old, bit), bit);
+                    t = _mm256_blendv_epi8(_mm256_adds_epu8(t, h), _mm256_subs_epu8(t, h), was_on);
+                }
+                acc = _mm256_or_si256(acc, _mm256_andnot_si256(_mm256_cmpeq_epi8(_mm256_subs_epu8(g, t), zero), bit));
+            }
+            _mm256_storeu_si256((__m256i *)(frame + p * FRAME_WIDTH + x), acc);
+        }
+    }
+}
+#endif
+
+/**
+ * @Description: 灰度图转换为帧缓冲，有 SIMD 时阈值和有序抖动使用 SIMD 实现
+ * @param {const uint8_t} *gray: 灰度图，FRAME_WIDTH x FRAME_HEIGHT
+ * @param {int} stride: 灰度图每行的字节数
+ * @param {uint8_t} *frame: 输出帧缓冲
+ * @param {const uint8_t} *prev: 上一帧输出，NULL 表示不做时间稳定滤波
+ * @param {const PixConfig} *cfg: 转换参数
+ * @return {*}
+ */
+void pixconv_gray8(const uint8_t *gray, int stride, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg) {
+    if (cfg->dither != PIX_FLOYD_STEINBERG) {
+#ifdef PIXCONV_AVX2
+        if (have_avx2()) {
+            pixconv_gray8_avx2(gray, stride, frame, prev, cfg);
+            return;
+        }
+#endif
+#if defined(__SSE2__) || defined(__ARM_NEON)
+        pixconv_gray8_simd(gray, stride, frame, prev, cfg);
+        return;
+#endif
+    }
+    pixconv_gray8_scalar(gray, stride, frame, prev, cfg);
+}
+
+/**
+ * @Description: 单色图转换为帧缓冲，每 8 行 x 8 列一次位矩阵转置
+ * @param {const uint8_t} *src: 单色图，FRAME_WIDTH x FRAME_HEIGHT，每字节最高位为最左边的像素
+ * @param {int} stride: 每行的字节数
+ * @param {uint8_t} *frame: 输出帧缓冲
+ * @return {*}
+ */
+static void mono_to_frame(const uint8_t *src, int stride, uint8_t *frame) {
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        for (int k = 0; k < FRAME_WIDTH / 8; k++) {
+            uint64_t x = 0;
+
+            for (int r = 0; r < 8; r++)
+                x |= (uint64_t)src[(p * 8 + r) * stride + k] << (r * 8);
+            // 转置后第 i 字节是第 7 - i 列（最高位在左），小端序下字节反转即为从左到右的 8 列
+            x = __builtin_bswap64(pixconv_transpose8x8(x));
+            memcpy(frame + p * FRAME_WIDTH + k * 8, &x, 8);
+        }
+    }
+}
+
+/**
+ * @Description: 任意格式的图像转换为帧缓冲
+ *               单色图直接转置（不使用 prev 和 cfg），其他格式先转换为灰度再按 cfg 二值化
+ * @param {const void} *src: 输入图像，FRAME_WIDTH x FRAME_HEIGHT
+ * @param {int} stride: 输入每行的字节数
+ * @param {int} format: 输入像素格式 PixFormat
+ * @param {uint8_t} *frame: 输出帧缓冲
+ * @param {const uint8_t} *prev: 上一帧输出，NULL 表示不做时间稳定滤波
+ * @param {const PixConfig} *cfg: 转换参数
+ * @return {*}
+ */
+void pixconv_image(const void *src, int stride, int format, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg) {
+    uint8_t gray[FRAME_HEIGHT * FRAME_WIDTH];
+
+    if (format == PIX_FMT_MONO) {
+        mono_to_frame(src, stride, frame);
+        return;
+    }
+    if (format == PIX_FMT_GRAY8) {
+        pixconv_gray8(src, stride, frame, prev, cfg);
+        return;
+    }
+    pixconv_to_gray(src, stride, format, FRAME_WIDTH, FRAME_HEIGHT, gray, FRAME_WIDTH);
+    pixconv_gray8(gray, FRAME_WIDTH, frame, prev, cfg);
+}
+
+/**
+ * @Description: 任意格式的图像转换为帧缓冲（标量参考实现，单色图逐点转换）
+ * @param {const void} *src: 输入图像，FRAME_WIDTH x FRAME_HEIGHT
+ * @param {int} stride: 输入每行的字节数
+ * @param {int} format: 输入像素格式 PixFormat
+ * @param {uint8_t} *frame: 输出帧缓冲
+ * @param {const uint8_t} *prev: 上一帧输出，NULL 表示不做时间稳定滤波
+ * @param {const PixConfig} *cfg: 转换参数
+ * @return {*}
+ */
+void pixconv_image_scalar(const void *src, int stride, int format, uint8_t *frame, const uint8_t *prev, const PixConfig *cfg) {
+    uint8_t gray[FRAME_HEIGHT * FRAME_WIDTH];
+
+    if (format == PIX_FMT_MONO) {
+        const uint8_t *mono = src;
+
+        memset(frame, 0, FRAME_BUFFER_SIZE);
+        for (int y = 0; y < FRAME_HEIGHT; y++)
+            for (int x = 0; x < FRAME_WIDTH; x++)
+                if (mono[y * stride + x / 8] & (0x80 >> (x % 8)))
+                    frame[(y / 8) * FRAME_WIDTH + x] |= OLED_PIXEL_MASK(y);
+        return;
+    }
+    pixconv_to_gray_scalar(src, stride, format, FRAME_WIDTH, FRAME_HEIGHT, gray, FRAME_WIDTH);
+    pixconv_gray8_scalar(gray, FRAME_WIDTH, frame, prev, cfg);
+}
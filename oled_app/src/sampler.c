@@ -0,0 +1,431 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 16:35:09
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 16:35:09
+ * @Description: 硬件状态采样，文件只打开一次，每次用 pread 重新读取，不创建进程也不分配内存
+ *               /proc 和 /sys 的文件从偏移 0 读取时内核会重新生成内容
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+
+#include "sampler.h"
+
+/* 数据来源 */
+#define PROC_STAT   "/proc/stat"
+#define CPU_FREQ    "/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq"
+#define GPU_LOAD    "/sys/class/devfreq/fb000000.gpu/load"
+#define NPU_LOAD    "/sys/kernel/debug/rknpu/load"
+#define THERMAL_DIR "/sys/class/thermal"
+#define THERMAL_MAX 16  // 查找的温度传感器个数
+
+/* 已打开的文件，打开失败为 -1 */
+static int stat_fd = -1, freq_fd = -1, gpu_fd = -1, npu_fd = -1, temp_fd = -1;
+
+/* 上次采样的 CPU 时间，计算两次采样之间的占用率 */
+static unsigned long long prev_total, prev_idle;
+
+/**
+ * @Description: 从头读取文件内容
+ * @param {int} fd: 文件描述符
+ * @param {char} *buf: 缓冲区
+ * @param {size_t} size: 缓冲区大小
+ * @return {*} 读取的字节数，失败返回 -1
+ */
+static int read_file(int fd, char *buf, size_t size) {
+    ssize_t n;
+
+    if (fd < 0)
+        return -1;
+    n = pread(fd, buf, size - 1, 0);
+    if (n < 0)
+        return -1;
+    buf[n] = '\0';
+    return n;
+}
+
+/**
+ * @Description: 读取 /proc/stat 第一行的 CPU 总时间和空闲时间
+ * @param {unsigned long long} *total: 总时间
+ * @param {unsigned long long} *idle: 空闲时间（idle + iowait）
+ * @return {*} 0 成功，-1 失败
+ */
+static int read_cpu_times(unsigned long long *total, unsigned long long *idle) {
+    char buf[256]; // 只需要第一行
+    char *p, *end;
+
+    if (read_file(stat_fd, buf, sizeof(buf)) < 0 || strncmp(buf, "cpu ", 4) != 0)
+        return -1;
+
+    // user nice system idle iowait irq softirq steal，guest 已经算在 user 里
+    *total = *idle = 0;
+    p = buf + 4;
+    for (int i = 0; i < 8; i++, p = end) {
+        unsigned long long v = strtoull(p, &end, 10);
+        if (end == p)
+            break;
+        *total += v;
+        if (i == 3 || i == 4)
+            *idle += v;
+    }
+    return 0;
+}
+
+/**
+ * @Description: 打开温度传感器，优先选择 CPU/SoC 的温度
+ * @return {*} 文件描述符，没有时返回 -1
+ */
+static int open_thermal_zone(void) {
+    char path[64], type[32];
+    int fd, first = -1;
+
+    for (int i = 0; i < THERMAL_MAX; i++) {
+        snprintf(path, sizeof(path), THERMAL_DIR "/thermal_zone%d/type", i);
+        fd = open(path, O_RDONLY);
+        if (fd < 0)
+            break;
+        if (read_file(fd, type, sizeof(type)) < 0)
+            type[0] = '\0';
+        close(fd);
+
+        if (first < 0)
+            first = i;
+        if (strstr(type, "soc") || strstr(type, "cpu")) {
+            first = i;
+            break;
+        }
+    }
+    if (first < 0)
+        return -1;
+    snprintf(path, sizeof(path), THERMAL_DIR "/thermal_zone%d/temp", first);
+    return open(path, O_RDONLY);
+}
+
+/**
+ * @Description: 打开所有数据来源，不存在的来源在采样时返回 -1
+ * @return {*} 0 成功，-1 连 /proc/stat 都无法打开
+ */
+int sampler_init(void) {
+    stat_fd = open(PROC_STAT, O_RDONLY);
+    freq_fd = open(CPU_FREQ, O_RDONLY);
+    gpu_fd = open(GPU_LOAD, O_RDONLY);
+    npu_fd = open(NPU_LOAD, O_RDONLY);
+    temp_fd = open_thermal_zone();
+
+    if (stat_fd < 0) {
+        perror("Failed to open " PROC_STAT);
+        return -1;
+    }
+    // 第一次采样作为基准
+    read_cpu_times(&prev_total, &prev_idle);
+    return 0;
+}
+
+/**
+ * @Description: 关闭所有数据来源
+ * @return {*}
+ */
+void sampler_close(void) {
+    int *fds[] = { &stat_fd, &freq_fd, &gpu_fd, &npu_fd, &temp_fd };
+
+    for (int i = 0; i < (int)(sizeof(fds) / sizeof(fds[0])); i++) {
+        if (*fds[i] >= 0)
+            close(*fds[i]);
+        *fds[i] = -1;
+    }
+}
+
+/**
+ * @Description: CPU 占用率，按两次采样之间的差值计算
+ * @return {*} 占用率（0.01% 为单位，0~10000），失败返回 -1
+ */
+int sample_cpu_usage(void) {
+    unsigned long long total, idle, dt, di;
+    static int last = 0;
+
+    if (read_cpu_times(&total, &idle) < 0)
+        return -1;
+    dt = total - prev_total;
+    di = idle - prev_idle;
+    // 两次采样间隔太短时沿用上次的结果
+    if (dt == 0)
+        return last;
+    prev_total = total;
+    prev_idle = idle;
+    last = (int)((dt - di) * 10000 / dt);
+    return last;
+}
+
+/**
+ * @Description: CPU0 当前频率
+ * @return {*} 频率（MHz），失败返回 -1
+ */
+int sample_cpu_frequency(void) {
+    char buf[32];
+
+    if (read_file(freq_fd, buf, sizeof(buf)) < 0)
+        return -1;
+    return atoi(buf) / 1000;
+}
+
+/**
+ * @Description: GPU 占用率，文件格式为 "占用率@频率Hz"
+ * @return {*} 占用率（%），失败返回 -1
+ */
+int sample_gpu_load(void) {
+    char buf[32];
+
+    if (read_file(gpu_fd, buf, sizeof(buf)) < 0 || !strchr(buf, '@'))
+        return -1;
+    return atoi(buf);
+}
+
+/**
+ * @Description: NPU 各核心占用率，文件格式为 "NPU load:  Core0:  0%, Core1:  0%, Core2:  0%,"
+ * @param {int} *loads: 输出各核心的占用率
+ * @param {int} max: loads 数组大小
+ * @return {*} 核心个数，失败返回 -1
+ */
+int sample_npu_load(int *loads, int max) {
+    char buf[128];
+    char *p;
+    int n = 0;
+
+    if (read_file(npu_fd, buf, sizeof(buf)) < 0)
+        return -1;
+    for (p = buf; n < max && (p = strchr(p, '%')) != NULL; p++) {
+        char *num = p;
+        // 回溯到 % 前数字的起始位置
+        while (num > buf && isdigit((unsigned char)num[-1]))
+            num--;
+        if (num == p)
+            continue;
+        loads[n++] = atoi(num);
+    }
+    return n;
+}
+
+/**
+ * @Description: 芯片温度
+ * @param {int} *millicelsius: 输出温度（0.001°C 为单位，可能为负）
+ * @return {*} 0 成功，失败返回 -1
+ */
+int sample_temperature(int *millicelsius) {
+    char buf[32];
+
+    if (read_file(temp_fd, buf, sizeof(buf)) < 0)
+        return -1;
+    *millicelsius = atoi(buf);
+    return 0;
+}
+
+/***************************** 后台采样 ******************************/
+/*
+ * 每个数据来源一个线程，按各自的周期采样，结果发布到一个顺序锁槽位
+ * 每个槽位只有一个写者（对应的采样线程），渲染循环读取最新值时不会阻塞在 I/O 上
+ * 写者：seq 变为奇数 -> 写数据 -> seq 变为偶数；读者看到奇数或前后 seq 不一致就重读
+ */
+typedef struct {
+    atomic_uint seq;                        // 顺序号，奇数表示正在写
+    atomic_int count;                       // 数值个数，-1 表示还没有数据或读取失败
+    atomic_int values[SAMPLER_VALUES_MAX];
+} SampleSlot;
+
+/* 采样函数，返回数值个数，失败返回 -1 */
+typedef int (*SampleFunc)(int *values, int max);
+
+static int read_cpu(int *values, int max) {
+    return (values[0] = sample_cpu_usage()) < 0 ? -1 : 1;
+}
+
+static int read_cpu_freq(int *values, int max) {
+    return (values[0] = sample_cpu_frequency()) < 0 ? -1 : 1;
+}
+
+static int read_gpu(int *values, int max) {
+    return (values[0] = sample_gpu_load()) < 0 ? -1 : 1;
+}
+
+static int read_temp(int *values, int max) {
+    return sample_temperature(&values[0]) < 0 ? -1 : 1;
+}
+
+/* 数据来源及采样周期（debugfs 的 NPU 负载读取较慢，单独放在一个线程） */
+static const struct {
+    SampleFunc read;
+    int period_ms;
+} sources[SAMPLE_SOURCES] = {
+    [SAMPLE_CPU]      = { read_cpu,        500 },
+    [SAMPLE_CPU_FREQ] = { read_cpu_freq,   500 },
+    [SAMPLE_GPU]      = { read_gpu,        500 },
+    [SAMPLE_NPU]      = { sample_npu_load, 1000 },
+    [SAMPLE_TEMP]     = { read_temp,       5000 },  // 温度变化慢
+};
+
+static SampleSlot slots[SAMPLE_SOURCES];
+static SampleHistory histories[SAMPLE_SOURCES];
+static pthread_t threads[SAMPLE_SOURCES];
+static int started[SAMPLE_SOURCES];
+
+/**
+ * @Description: 发布一次采样结果
+ * @param {SampleSlot} *slot: 槽位
+ * @param {const int} *values: 数值
+ * @param {int} count: 数值个数，-1 表示采样失败
+ * @return {*}
+ */
+static void slot_publish(SampleSlot *slot, const int *values, int count) {
+    unsigned seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release); // 奇数的 seq 先于数据可见
+    atomic_store_explicit(&slot->count, count, memory_order_relaxed);
+    for (int i = 0; i < count; i++)
+        atomic_store_explicit(&slot->values[i], values[i], memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+}
+
+/**
+ * @Description: 记录一次采样到历史，只有一个写者，先写数据再发布 head
+ * @param {SampleHistory} *h: 历史记录
+ * @param {const int} *values: 数值
+ * @param {int} count: 数值个数
+ * @return {*}
+ */
+static void history_push(SampleHistory *h, const int *values, int count) {
+    unsigned head = atomic_load_explicit(&h->head, memory_order_relaxed);
+    int sum = 0;
+
+    for (int i = 0; i < count; i++)
+        sum += values[i];
+    atomic_store_explicit(&h->data[head % SAMPLER_HISTORY], sum / count, memory_order_relaxed);
+    atomic_store_explicit(&h->head, head + 1, memory_order_release);
+}
+
+/**
+ * @Description: 采样线程，按绝对时间周期运行，采样耗时不会累积成漂移
+ * @param {void} *arg: 数据来源编号
+ * @return {*}
+ */
+static void *sampler_thread(void *arg) {
+    int source = (int)(long)arg;
+    int values[SAMPLER_VALUES_MAX];
+    struct timespec next;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (1) {
+        int count = sources[source].read(values, SAMPLER_VALUES_MAX);
+        slot_publish(&slots[source], values, count);
+        if (count > 0) // 失败的采样不记录，图表暂停滚动
+            history_push(&histories[source], values, count);
+
+        next.tv_nsec += sources[source].period_ms * 1000000L;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        // clock_nanosleep 是取消点，sampler_stop 可以在这里结束线程
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+
+/**
+ * @Description: 启动采样线程，需要先调用 sampler_init
+ * @return {*} 0 成功，-1 失败
+ */
+int sampler_start(void) {
+    sigset_t all, old;
+    int ret = 0;
+
+    // 采样线程继承创建时的信号掩码，屏蔽所有信号，退出信号只由主线程处理
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    for (int i = 0; i < SAMPLE_SOURCES; i++) {
+        atomic_store(&slots[i].count, -1);
+        if (pthread_create(&threads[i], NULL, sampler_thread, (void *)(long)i) != 0) {
+            perror("Failed to start sampler thread");
+            sampler_stop();
+            ret = -1;
+            break;
+        }
+        started[i] = 1;
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    return ret;
+}
+
+/**
+ * @Description: 停止采样线程
+ * @return {*}
+ */
+void sampler_stop(void) {
+    for (int i = 0; i < SAMPLE_SOURCES; i++) {
+        if (!started[i])
+            continue;
+        pthread_cancel(threads[i]);
+        pthread_join(threads[i], NULL);
+        started[i] = 0;
+    }
+}
+
+/**
+ * @Description: 读取数据来源最近一次发布的结果，不阻塞
+ * @param {int} source: 数据来源 SampleSource
+ * @param {int} *values: 输出数值
+ * @param {int} max: values 数组大小
+ * @return {*} 数值个数，还没有数据或采样失败返回 -1
+ */
+int sampler_latest(int source, int *values, int max) {
+    SampleSlot *slot;
+    unsigned seq;
+    int count;
+
+    if (source < 0 || source >= SAMPLE_SOURCES)
+        return -1;
+    slot = &slots[source];
+    do {
+        // 写者正在写时重读（写一次只需要几条指令）
+        while ((seq = atomic_load_explicit(&slot->seq, memory_order_acquire)) & 1)
+            ;
+        count = atomic_load_explicit(&slot->count, memory_order_relaxed);
+        if (count > max)
+            count = max;
+        for (int i = 0; i < count; i++)
+            values[i] = atomic_load_explicit(&slot->values[i], memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire); // 数据先于第二次读取 seq
+    } while (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq);
+    return count;
+}
+
+/**
+ * @Description: 数据来源的采样周期，显示它的控件不需要更快地更新
+ * @param {int} source: 数据来源 SampleSource
+ * @return {*} 周期（ms），来源不存在时返回 -1
+ */
+int sampler_period(int source) {
+    if (source < 0 || source >= SAMPLE_SOURCES)
+        return -1;
+    return sources[source].period_ms;
+}
+
+/**
+ * @Description: 取得数据来源的历史记录，与采样线程共用，不复制
+ * @param {int} source: 数据来源 SampleSource
+ * @return {*} 历史记录，来源不存在时返回 NULL
+ */
+SampleHistory *sampler_history(int source) {
+    if (source < 0 || source >= SAMPLE_SOURCES)
+        return NULL;
+    return &histories[source];
+}
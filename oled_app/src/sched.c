@@ -0,0 +1,248 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 23:31:52
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 23:31:52
+ * @Description: 多周期调度
+ *               每项有一个合并窗口（周期的 1/8，不超过 SCHED_SLACK_MAX_MS）：定时器设在各项 到期时间 + 窗口 的最小值，
+ *               醒来后运行所有已到期的项，再在耗时预算内提前运行窗口内即将到期的项，于是相近的项共用一次唤醒
+ *               下次到期时间按周期累加，提前或推迟运行不会累积漂移；落后超过一个周期时跳过错过的周期
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include <stdio.h>
+#include <time.h>
+
+#include "sched.h"
+
+/* 调度项 */
+typedef struct {
+    const char *name;
+    int period_ms;          // 声明的周期
+    int flags;              // 调度项标志
+    SchedFunc run;
+    void *arg;
+    int enabled;
+    long long due;          // 下次到期时间（ns，CLOCK_REALTIME）
+    long long cost_ns;      // 耗时估计，初始为声明值，每次运行后按实测值平滑
+    unsigned long runs;     // 运行次数
+    unsigned long changed;  // 改变了可见内容的次数
+    unsigned long early;    // 提前合并运行的次数
+    unsigned long skipped;  // 错过的周期
+} SchedItem;
+
+static SchedItem items[SCHED_MAX_ITEMS];
+static int item_count;
+static int min_period_ms;       // 所有项的最短周期（--interval），0 表示不限制
+static unsigned long wakeups;   // 运行过至少一项的唤醒次数
+
+/**
+ * @Description: 当前墙上时间（ns）
+ * @return {*}
+ */
+static long long now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @Description: 实际周期（ns），不短于最短周期
+ * @return {*}
+ */
+static long long period_ns(const SchedItem *it) {
+    return (long long)(it->period_ms > min_period_ms ? it->period_ms : min_period_ms) * 1000000LL;
+}
+
+/**
+ * @Description: 合并窗口（ns）
+ * @return {*}
+ */
+static long long slack_ns(const SchedItem *it) {
+    long long slack = period_ns(it) / 8;
+
+    return slack < SCHED_SLACK_MAX_MS * 1000000LL ? slack : SCHED_SLACK_MAX_MS * 1000000LL;
+}
+
+/**
+ * @Description: 从现在开始安排第一次运行：对齐的项在下一个周期整数倍，其他项在一个周期之后
+ * @return {*}
+ */
+static void schedule_first(SchedItem *it, long long now) {
+    long long p = period_ns(it);
+
+    it->due = it->flags & SCHED_ALIGN ? (now / p + 1) * p : now + p;
+}
+
+/**
+ * @Description: 添加调度项，添加后即启用
+ * @param {const char} *name: 名称（统计信息）
+ * @param {int} period_ms: 周期
+ * @param {int} cost_us: 预计耗时
+ * @param {int} flags: 调度项标志
+ * @param {SchedFunc} run: 运行函数
+ * @param {void} *arg: 运行函数的参数
+ * @return {*} 编号，调度项已满或周期无效时返回 -1
+ */
+int sched_add(const char *name, int period_ms, int cost_us, int flags, SchedFunc run, void *arg) {
+    SchedItem *it;
+
+    if (item_count >= SCHED_MAX_ITEMS || period_ms <= 0)
+        return -1;
+    it = &items[item_count];
+    *it = (SchedItem){ .name = name, .period_ms = period_ms, .flags = flags, .run = run, .arg = arg,
+                       .enabled = 1, .cost_ns = cost_us * 1000LL };
+    schedule_first(it, now_ns());
+    return item_count++;
+}
+
+/**
+ * @Description: 启用或停用调度项，启用时从现在开始重新计时
+ * @param {int} id: 编号
+ * @param {int} enable: 1 启用，0 停用
+ * @return {*}
+ */
+void sched_enable(int id, int enable) {
+    if (id < 0 || id >= item_count)
+        return;
+    items[id].enabled = enable;
+    if (enable)
+        schedule_first(&items[id], now_ns());
+}
+
+/**
+ * @Description: 修改调度项的周期，从现在开始重新计时
+ * @param {int} id: 编号
+ * @param {int} period_ms: 周期
+ * @return {*}
+ */
+void sched_set_period(int id, int period_ms) {
+    if (id < 0 || id >= item_count || period_ms <= 0)
+        return;
+    items[id].period_ms = period_ms;
+    schedule_first(&items[id], now_ns());
+}
+
+/**
+ * @Description: 设置所有项的最短周期，周期更短的项降低频率
+ * @param {int} period_ms: 最短周期，0 表示不限制
+ * @return {*}
+ */
+void sched_set_min_period(int period_ms) {
+    min_period_ms = period_ms > 0 ? period_ms : 0;
+    sched_reset();
+}
+
+/**
+ * @Description: 所有启用的项从现在开始重新计时（系统时间被修改之后）
+ * @return {*}
+ */
+void sched_reset(void) {
+    long long now = now_ns();
+
+    for (int i = 0; i < item_count; i++)
+        if (items[i].enabled)
+            schedule_first(&items[i], now);
+}
+
+/**
+ * @Description: 下一次需要醒来的时间：各项 到期时间 + 合并窗口 的最小值（对齐的项没有窗口）
+ * @return {*} 墙上时间（ns），没有启用的项时返回 -1
+ */
+long long sched_next(void) {
+    long long next = -1;
+
+    for (int i = 0; i < item_count; i++) {
+        // 对齐的项准时运行，不推迟
+        long long t = items[i].due + (items[i].flags & SCHED_ALIGN ? 0 : slack_ns(&items[i]));
+
+        if (items[i].enabled && (next < 0 || t < next))
+            next = t;
+    }
+    return next;
+}
+
+/**
+ * @Description: 运行一项，更新耗时估计和下次到期时间
+ * @param {SchedItem} *it: 调度项
+ * @return {*} 运行函数的返回值
+ */
+static int run_item(SchedItem *it) {
+    struct timespec t0, t1;
+    long long p = period_ns(it), now, ns;
+    int ret;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    ret = it->run(it->arg);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ns = (t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec);
+    it->cost_ns = (it->cost_ns * 7 + ns) / 8;
+    it->runs++;
+    it->changed += ret > 0;
+
+    // 运行函数可能重新启用了自己（重新计时），只在原来的时间上累加
+    now = now_ns();
+    if (it->due > now + slack_ns(it))
+        return ret;
+    it->due += p;
+    if (it->due <= now) {
+        long long missed = (now - it->due) / p + 1;
+
+        it->skipped += missed;
+        it->due += missed * p;
+    }
+    return ret;
+}
+
+/**
+ * @Description: 运行所有到期的项，再在耗时预算内提前运行合并窗口内即将到期的项
+ *               对齐的项不提前运行
+ * @return {*} 1 有项改变了可见内容，0 没有（不需要绘制），-1 有项出错
+ */
+int sched_run(void) {
+    long long now = now_ns(), budget = SCHED_BUDGET_US * 1000LL;
+    int ran = 0, changed = 0, ret;
+
+    for (int i = 0; i < item_count; i++) {
+        SchedItem *it = &items[i];
+
+        if (!it->enabled || it->due > now)
+            continue;
+        budget -= it->cost_ns;
+        ran = 1;
+        if ((ret = run_item(it)) < 0)
+            return -1;
+        changed |= ret;
+    }
+    for (int i = 0; i < item_count; i++) {
+        SchedItem *it = &items[i];
+
+        if (!it->enabled || it->due <= now || it->due - slack_ns(it) > now ||
+            (it->flags & SCHED_ALIGN) || it->cost_ns > budget)
+            continue;
+        budget -= it->cost_ns;
+        ran = 1;
+        it->early++;
+        if ((ret = run_item(it)) < 0)
+            return -1;
+        changed |= ret;
+    }
+    wakeups += ran;
+    return changed;
+}
+
+/**
+ * @Description: 打印调度统计
+ * @return {*}
+ */
+void sched_print_stats(void) {
+    printf("Scheduler wakeups: %lu\n", wakeups);
+    for (int i = 0; i < item_count; i++) {
+        SchedItem *it = &items[i];
+
+        printf("  %-10s %6d ms: runs %lu (changed %lu, early %lu), skipped %lu, cost %lld us%s\n",
+               it->name, it->period_ms, it->runs, it->changed, it->early, it->skipped,
+               it->cost_ns / 1000, it->enabled ? "" : " (off)");
+    }
+}
@@ -0,0 +1,376 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 22:20:14
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 22:20:14
+ * @Description: 多客户端显示服务，图层是客户端共享过来的 memfd，服务只读映射
+ *               客户端的脏矩形和底层界面的脏矩形按页记录变化的列范围，合成时只重新合成这些范围：
+ *               先复制底层界面，再按优先级从低到高叠加各图层（不透明 ROP_COPY，透明 ROP_OR），
+ *               最后与帧缓冲比较，只发送变化的字节
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#define _GNU_SOURCE // accept4, memfd_create
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+
+#include "server.h"
+#include "surface.h"
+
+/* 图层 */
+typedef struct {
+    int fd;                 // 客户端连接，-1 表示空闲
+    uint8_t *data;          // 共享内存的只读映射，NULL 表示还没有申请区域
+    size_t size;            // 映射大小
+    Surface surface;        // 图层内容
+    short x, y;             // 图层在屏幕上的位置
+    int priority;           // 优先级
+    int op;                 // 叠加方式 RasterOp
+} Layer;
+
+static int listen_fd = -1;
+static char socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static Layer layers[SERVER_MAX_LAYERS];
+static Layer *order[SERVER_MAX_LAYERS];    // 已申请区域的图层，按优先级从低到高
+static int order_count;
+
+/* 每页需要重新合成的列范围，x1 为 -1 表示该页不需要 */
+static short dirty_x0[FRAME_HEIGHT / 8], dirty_x1[FRAME_HEIGHT / 8];
+/* 合成后的画面 */
+static uint8_t composed[FRAME_BUFFER_SIZE];
+
+/**
+ * @Description: 记录需要重新合成的区域（屏幕坐标，闭区间）
+ * @return {*}
+ */
+static void mark_dirty(int x0, int y0, int x1, int y1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= FRAME_WIDTH) x1 = FRAME_WIDTH - 1;
+    if (y1 >= FRAME_HEIGHT) y1 = FRAME_HEIGHT - 1;
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    for (int p = y0 / 8; p <= y1 / 8; p++) {
+        if (dirty_x1[p] < 0) {
+            dirty_x0[p] = x0;
+            dirty_x1[p] = x1;
+            continue;
+        }
+        if (x0 < dirty_x0[p])
+            dirty_x0[p] = x0;
+        if (x1 > dirty_x1[p])
+            dirty_x1[p] = x1;
+    }
+}
+
+/**
+ * @Description: 监听显示服务的 socket，并加入主循环的 epoll
+ * @param {const char} *path: socket 路径
+ * @param {int} epfd: 主循环的 epoll
+ * @return {*} 0 成功，-1 失败
+ */
+int server_open(const char *path, int epfd) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    struct epoll_event ev = { .events = EPOLLIN };
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Server socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    // 设备已被 flock 独占，残留的 socket 文件只可能来自上次异常退出
+    unlink(path);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, SERVER_MAX_LAYERS) < 0) {
+        perror(path);
+        close(listen_fd);
+        listen_fd = -1;
+        return -1;
+    }
+    chmod(path, 0660); // 同组的进程可以申请屏幕区域
+    strcpy(socket_path, path);
+
+    for (int i = 0; i < SERVER_MAX_LAYERS; i++)
+        layers[i].fd = -1;
+    order_count = 0;
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++)
+        dirty_x1[p] = -1;
+    mark_dirty(0, 0, FRAME_WIDTH - 1, FRAME_HEIGHT - 1);
+
+    ev.data.fd = listen_fd;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, listen_fd, &ev) < 0) {
+        perror("epoll_ctl");
+        server_close();
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @Description: 断开客户端，释放图层，图层原来的区域需要重新合成
+ * @param {Layer} *l: 图层
+ * @return {*}
+ */
+static void layer_remove(Layer *l) {
+    if (l->data) {
+        int i = 0;
+
+        while (order[i] != l)
+            i++;
+        memmove(&order[i], &order[i + 1], (order_count - i - 1) * sizeof(order[0]));
+        order_count--;
+        mark_dirty(l->x, l->y, l->x + l->surface.width - 1, l->y + l->surface.height - 1);
+        munmap(l->data, l->size);
+        l->data = NULL;
+    }
+    close(l->fd); // 关闭时自动从 epoll 中移除
+    l->fd = -1;
+}
+
+/**
+ * @Description: 关闭所有连接并删除 socket 文件
+ * @return {*}
+ */
+void server_close(void) {
+    if (listen_fd < 0)
+        return;
+    for (int i = 0; i < SERVER_MAX_LAYERS; i++)
+        if (layers[i].fd >= 0)
+            layer_remove(&layers[i]);
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(socket_path);
+}
+
+/**
+ * @Description: 回复 SERVER_CREATE，成功时通过 SCM_RIGHTS 附带 memfd
+ * @param {int} fd: 客户端
+ * @param {ServerMsg} *msg: 回复内容
+ * @param {int} memfd: 共享内存，-1 表示不附带
+ * @return {*}
+ */
+static void send_reply(int fd, ServerMsg *msg, int memfd) {
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } ctrl;
+    struct iovec iov = { .iov_base = msg, .iov_len = sizeof(*msg) };
+    struct msghdr mh = { .msg_iov = &iov, .msg_iovlen = 1 };
+
+    msg->type = SERVER_REPLY;
+    if (memfd >= 0) {
+        struct cmsghdr *cm;
+
+        mh.msg_control = ctrl.buf;
+        mh.msg_controllen = sizeof(ctrl.buf);
+        cm = CMSG_FIRSTHDR(&mh);
+        cm->cmsg_level = SOL_SOCKET;
+        cm->cmsg_type = SCM_RIGHTS;
+        cm->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cm), &memfd, sizeof(int));
+    }
+    if (sendmsg(fd, &mh, MSG_NOSIGNAL | MSG_DONTWAIT) < 0)
+        perror("server reply");
+}
+
+/**
+ * @Description: 为客户端创建图层：分配 memfd，封住大小（客户端缩小文件会让服务读取时 SIGBUS），只读映射
+ * @param {Layer} *l: 图层
+ * @param {ServerMsg} *msg: SERVER_CREATE 消息，返回时为回复
+ * @return {*} memfd，失败时返回 -1，msg->status 为 -errno
+ */
+static int layer_create(Layer *l, ServerMsg *msg) {
+    size_t size;
+    int memfd, i;
+
+    if (l->data) {
+        msg->status = -EBUSY;   // 每个连接一个图层
+        return -1;
+    }
+    if (msg->w <= 0 || msg->h <= 0 || msg->x < 0 || msg->y < 0 ||
+        msg->x + msg->w > FRAME_WIDTH || msg->y + msg->h > FRAME_HEIGHT) {
+        msg->status = -EINVAL;
+        return -1;
+    }
+
+    size = (size_t)(msg->h + 7) / 8 * msg->w;
+    memfd = memfd_create("spi_oled_layer", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd < 0 || ftruncate(memfd, size) < 0 ||
+        fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0) {
+        msg->status = -errno;
+        if (memfd >= 0)
+            close(memfd);
+        return -1;
+    }
+    l->data = mmap(NULL, size, PROT_READ, MAP_SHARED, memfd, 0);
+    if (l->data == MAP_FAILED) {
+        msg->status = -errno;
+        l->data = NULL;
+        close(memfd);
+        return -1;
+    }
+
+    l->size = size;
+    surface_init(&l->surface, l->data, msg->w, msg->h, msg->w);
+    l->x = msg->x;
+    l->y = msg->y;
+    l->priority = msg->priority;
+    l->op = msg->flags & SERVER_LAYER_OR ? ROP_OR : ROP_COPY;
+
+    // 插入到同优先级图层的后面，后申请的在上面
+    for (i = order_count; i > 0 && order[i - 1]->priority > l->priority; i--)
+        order[i] = order[i - 1];
+    order[i] = l;
+    order_count++;
+    mark_dirty(l->x, l->y, l->x + msg->w - 1, l->y + msg->h - 1);
+
+    msg->status = 0;
+    msg->size = size;
+    return memfd;
+}
+
+/**
+ * @Description: 处理显示服务的事件：接受新客户端，或处理客户端的消息
+ * @param {int} epfd: 主循环的 epoll
+ * @param {int} fd: 有事件的文件描述符
+ * @return {*} 1 需要重新合成，0 不需要，-1 不是显示服务的文件描述符
+ */
+int server_handle(int epfd, int fd) {
+    Layer *l = NULL;
+    ServerMsg msg;
+    ssize_t n;
+
+    if (listen_fd < 0)
+        return -1;
+    if (fd == listen_fd) {
+        int c;
+
+        while ((c = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+            struct epoll_event ev = { .events = EPOLLIN, .data.fd = c };
+
+            for (int i = 0; i < SERVER_MAX_LAYERS && !l; i++)
+                if (layers[i].fd < 0)
+                    l = &layers[i];
+            if (!l || epoll_ctl(epfd, EPOLL_CTL_ADD, c, &ev) < 0) {
+                close(c);   // 客户端读到 EOF
+                continue;
+            }
+            l->fd = c;
+            l->data = NULL;
+            l = NULL;
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < SERVER_MAX_LAYERS && !l; i++)
+        if (layers[i].fd == fd)
+            l = &layers[i];
+    if (!l)
+        return -1;
+
+    n = recv(fd, &msg, sizeof(msg), MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+        return 0;
+    if (n <= 0) {
+        int had_layer = l->data != NULL;
+
+        layer_remove(l);
+        return had_layer;
+    }
+    if (n != sizeof(msg)) {
+        msg = (ServerMsg){ .status = -EINVAL };
+        send_reply(fd, &msg, -1);
+        return 0;
+    }
+
+    switch (msg.type) {
+        case SERVER_CREATE: {
+            int memfd = layer_create(l, &msg);
+
+            send_reply(fd, &msg, memfd);
+            if (memfd >= 0)
+                close(memfd);   // 服务保留映射即可
+            return memfd >= 0;
+        }
+        case SERVER_DAMAGE:
+            if (!l->data)
+                return 0;
+            // 裁剪到图层范围内再换算为屏幕坐标
+            if (msg.x < 0) { msg.w += msg.x; msg.x = 0; }
+            if (msg.y < 0) { msg.h += msg.y; msg.y = 0; }
+            if (msg.x + msg.w > l->surface.width) msg.w = l->surface.width - msg.x;
+            if (msg.y + msg.h > l->surface.height) msg.h = l->surface.height - msg.y;
+            if (msg.w <= 0 || msg.h <= 0)
+                return 0;
+            mark_dirty(l->x + msg.x, l->y + msg.y, l->x + msg.x + msg.w - 1, l->y + msg.y + msg.h - 1);
+            return 1;
+        default:
+            msg.status = -EINVAL;
+            send_reply(fd, &msg, -1);
+            return 0;
+    }
+}
+
+/**
+ * @Description: 按优先级合成底层界面和各图层，把变化的字节发布到帧缓冲
+ * @param {const uint8_t} *base: 底层界面画面（帧缓冲布局）
+ * @param {const Rect} *base_damage: 底层界面变化的区域
+ * @param {int} base_count: 底层界面脏矩形个数
+ * @param {uint8_t} *frame_buffer: 帧缓冲
+ * @param {Rect} *damage: 输出需要刷新到屏幕的脏矩形
+ * @param {int} max_damage: 脏矩形数组大小
+ * @return {*} 脏矩形个数，0 表示屏幕内容没有变化
+ */
+int server_compose(const uint8_t *base, const Rect *base_damage, int base_count,
+                   uint8_t *frame_buffer, Rect *damage, int max_damage) {
+    Surface dst, bottom, fb;
+    int dirty = 0;
+
+    for (int i = 0; i < base_count; i++)
+        mark_dirty(base_damage[i].x0, base_damage[i].y0, base_damage[i].x1, base_damage[i].y1);
+
+    surface_init(&dst, composed, FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH);
+    surface_init(&bottom, (uint8_t *)base, FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH);
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        int x0 = dirty_x0[p], x1 = dirty_x1[p], y0 = p * 8, y1 = p * 8 + 7;
+
+        if (x1 < 0)
+            continue;
+        dirty_x1[p] = -1;
+        dirty = 1;
+
+        surface_blit(&dst, x0, y0, &bottom, x0, y0, x1 - x0 + 1, 8, ROP_COPY, NULL);
+        for (int i = 0; i < order_count; i++) {
+            const Layer *l = order[i];
+            int lx0 = x0 > l->x ? x0 : l->x;
+            int lx1 = x1 < l->x + l->surface.width - 1 ? x1 : l->x + l->surface.width - 1;
+            int ly0 = y0 > l->y ? y0 : l->y;
+            int ly1 = y1 < l->y + l->surface.height - 1 ? y1 : l->y + l->surface.height - 1;
+
+            if (lx0 > lx1 || ly0 > ly1)
+                continue;
+            surface_blit(&dst, lx0, ly0, &l->surface, lx0 - l->x, ly0 - l->y,
+                         lx1 - lx0 + 1, ly1 - ly0 + 1, l->op, NULL);
+        }
+    }
+    if (!dirty)
+        return 0;
+
+    surface_init(&fb, frame_buffer, FRAME_WIDTH, FRAME_HEIGHT, FRAME_WIDTH);
+    return surface_publish(&fb, &dst, damage, max_damage);
+}
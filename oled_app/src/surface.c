@@ -0,0 +1,178 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 21:06:40
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 21:06:40
+ * @Description: 离屏绘制目标与光栅操作合成
+ *               页式布局中一个字节是同一列的 8 行，源和目标的行偏移相差 8 的整数倍时按字节直接操作，
+ *               否则每列取出跨两页的 16 位再移位得到对齐的 8 行
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include "surface.h"
+
+/**
+ * @Description: 使用已有的内存初始化绘制目标
+ * @param {Surface} *s: 绘制目标
+ * @param {uint8_t} *data: 页式数据，至少 (height + 7) / 8 * stride 字节
+ * @param {int} width: 宽度
+ * @param {int} height: 高度
+ * @param {int} stride: 相邻两页的字节间隔
+ * @return {*}
+ */
+void surface_init(Surface *s, uint8_t *data, int width, int height, int stride) {
+    s->data = data;
+    s->width = width;
+    s->height = height;
+    s->stride = stride;
+}
+
+/**
+ * @Description: 分配一个清空的绘制目标
+ * @param {Surface} *s: 绘制目标
+ * @param {int} width: 宽度
+ * @param {int} height: 高度
+ * @return {*} 0 成功，-1 内存不足
+ */
+int surface_create(Surface *s, int width, int height) {
+    uint8_t *data = calloc((height + 7) / 8, width);
+
+    if (!data)
+        return -1;
+    surface_init(s, data, width, height, width);
+    return 0;
+}
+
+/**
+ * @Description: 释放 surface_create 分配的绘制目标
+ * @param {Surface} *s: 绘制目标
+ * @return {*}
+ */
+void surface_destroy(Surface *s) {
+    free(s->data);
+    s->data = NULL;
+}
+
+/**
+ * @Description: 取出第 x 列从第 row 行开始的 8 行，最低位为第 row 行，超出范围的行为 0
+ * @param {const Surface} *s: 绘制目标
+ * @param {int} x: 列
+ * @param {int} row: 起始行，可以为负
+ * @return {*}
+ */
+static inline uint8_t column_bits(const Surface *s, int x, int row) {
+    int q = row >= 0 ? row / 8 : -((7 - row) / 8); // 向下取整
+    int pages = (s->height + 7) / 8;
+    unsigned lo = q >= 0 && q < pages ? s->data[q * s->stride + x] : 0;
+    unsigned hi = q + 1 >= 0 && q + 1 < pages ? s->data[(q + 1) * s->stride + x] : 0;
+
+    return (uint8_t)((lo | hi << 8) >> (row - q * 8));
+}
+
+/**
+ * @Description: 按光栅操作把 src 的矩形区域合成到 dst，源和目标可以是任意行偏移
+ * @param {Surface} *dst: 目标
+ * @param {int} dx: 目标x坐标
+ * @param {int} dy: 目标y坐标
+ * @param {const Surface} *src: 源
+ * @param {int} sx: 源x坐标
+ * @param {int} sy: 源y坐标
+ * @param {int} w: 宽度
+ * @param {int} h: 高度
+ * @param {int} op: 光栅操作 RasterOp
+ * @param {const Surface} *mask: ROP_MASKED 的掩码，与 src 尺寸相同，其他操作为 NULL
+ * @return {*}
+ */
+void surface_blit(Surface *dst, int dx, int dy, const Surface *src, int sx, int sy, int w, int h,
+                  int op, const Surface *mask) {
+    // 裁剪到源和目标范围内
+    if (sx < 0) { dx -= sx; w += sx; sx = 0; }
+    if (sy < 0) { dy -= sy; h += sy; sy = 0; }
+    if (dx < 0) { sx -= dx; w += dx; dx = 0; }
+    if (dy < 0) { sy -= dy; h += dy; dy = 0; }
+    if (sx + w > src->width) w = src->width - sx;
+    if (sy + h > src->height) h = src->height - sy;
+    if (dx + w > dst->width) w = dst->width - dx;
+    if (dy + h > dst->height) h = dst->height - dy;
+    if (w <= 0 || h <= 0 || (op == ROP_MASKED && !mask))
+        return;
+
+    for (int p = dy / 8; p <= (dy + h - 1) / 8; p++) {
+        int r0 = dy > p * 8 ? dy - p * 8 : 0;
+        int r1 = dy + h - 1 < p * 8 + 7 ? dy + h - 1 - p * 8 : 7;
+        uint8_t m = OLED_ROWS_MASK(r0, r1);
+        int row = sy + p * 8 - dy;       // 目标本页第 0 行对应的源行
+        int aligned = row >= 0 && row % 8 == 0;
+        const uint8_t *sp = src->data + (aligned ? row / 8 * src->stride : 0) + sx;
+        const uint8_t *mp = mask ? mask->data + (aligned ? row / 8 * mask->stride : 0) + sx : NULL;
+        uint8_t *d = dst->data + p * dst->stride + dx;
+
+        if (aligned && m == 0xFF && op == ROP_COPY) {
+            memcpy(d, sp, w);
+            continue;
+        }
+        if (aligned && m == 0xFF && op == ROP_MASKED) {
+            OLED_MergeMasked(d, sp, mp, w);
+            continue;
+        }
+        for (int c = 0; c < w; c++) {
+            uint8_t b = aligned ? sp[c] : column_bits(src, sx + c, row);
+
+            switch (op) {
+                case ROP_COPY:
+                    d[c] = (d[c] & ~m) | (b & m);
+                    break;
+                case ROP_OR:
+                    d[c] |= b & m;
+                    break;
+                case ROP_AND:
+                    d[c] &= b | ~m;
+                    break;
+                case ROP_XOR:
+                    d[c] ^= b & m;
+                    break;
+                case ROP_MASKED: {
+                    uint8_t k = (aligned ? mp[c] : column_bits(mask, sx + c, row)) & m;
+                    d[c] = (d[c] & ~k) | (b & k);
+                    break;
+                }
+                default:
+                    return;
+            }
+        }
+    }
+}
+
+/**
+ * @Description: 把离屏画面发布到目标（通常是帧缓冲），每页只复制变化的字节
+ * @param {Surface} *dst: 目标，与 src 尺寸相同，高度不超过 FRAME_HEIGHT
+ * @param {const Surface} *src: 离屏画面
+ * @param {Rect} *damage: 输出变化的区域
+ * @param {int} max_damage: 脏矩形数组大小
+ * @return {*} 脏矩形个数，0 表示没有变化
+ */
+int surface_publish(Surface *dst, const Surface *src, Rect *damage, int max_damage) {
+    short x0[FRAME_HEIGHT / 8], x1[FRAME_HEIGHT / 8];
+    int pages = (src->height + 7) / 8;
+
+    if (src->width != dst->width || src->height != dst->height || pages > FRAME_HEIGHT / 8)
+        return 0;
+
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        uint8_t *a = dst->data + p * dst->stride;
+        const uint8_t *b = src->data + p * src->stride;
+        int l = 0, r = src->width - 1;
+
+        x1[p] = -1;
+        if (p >= pages || memcmp(a, b, src->width) == 0)
+            continue;
+        while (a[l] == b[l])
+            l++;
+        while (a[r] == b[r])
+            r--;
+        memcpy(a + l, b + l, r - l + 1);
+        x0[p] = l;
+        x1[p] = r;
+    }
+    return OLED_PageDamage(x0, x1, damage, max_damage);
+}
@@ -0,0 +1,141 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 21:10:03
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 21:10:03
+ * @Description: 界面切换动画，由两个离屏界面合成过渡帧
+ *               水平移动按页逐行 memcpy，垂直移动把相邻两页按位移拼接，每帧只发送变化的区域
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include "transition.h"
+
+/* 8x8 Bayer 矩阵（0~63），溶解时序号小于进度的点先换成新界面 */
+static const uint8_t bayer_index[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 },
+};
+
+/**
+ * @Description: 切换方式名称转换为 TransitionType
+ * @param {const char} *name: none/slide/wipe/push/fade
+ * @return {*} 切换方式，无法识别返回 -1
+ */
+int transition_parse(const char *name) {
+    static const char *names[] = { "none", "slide", "wipe", "push", "fade" };
+
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++)
+        if (strcmp(name, names[i]) == 0)
+            return i;
+    return -1;
+}
+
+/**
+ * @Description: 水平推入：旧界面左移 off 列，右边接上新界面的前 off 列
+ * @return {*}
+ */
+static void compose_slide(const uint8_t *from, const uint8_t *to, int off, uint8_t *out) {
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        const uint8_t *a = from + p * FRAME_WIDTH, *b = to + p * FRAME_WIDTH;
+        uint8_t *o = out + p * FRAME_WIDTH;
+
+        memcpy(o, a + off, FRAME_WIDTH - off);
+        memcpy(o + FRAME_WIDTH - off, b, off);
+    }
+}
+
+/**
+ * @Description: 擦除：左边 off 列已经是新界面
+ * @return {*}
+ */
+static void compose_wipe(const uint8_t *from, const uint8_t *to, int off, uint8_t *out) {
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        memcpy(out + p * FRAME_WIDTH, to + p * FRAME_WIDTH, off);
+        memcpy(out + p * FRAME_WIDTH + off, from + p * FRAME_WIDTH + off, FRAME_WIDTH - off);
+    }
+}
+
+/**
+ * @Description: 垂直推入：把旧界面和新界面看作上下相连的 16 页，从第 off 行开始取 8 页
+ *               行偏移不是 8 的整数倍时，每个字节由相邻两页移位拼接
+ * @return {*}
+ */
+static void compose_push(const uint8_t *from, const uint8_t *to, int off, uint8_t *out) {
+    int shift = off % 8;
+
+    for (int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        int q = p + off / 8;    // 拼接的上面一页
+        const uint8_t *a = q < FRAME_HEIGHT / 8 ? from + q * FRAME_WIDTH : to + (q - FRAME_HEIGHT / 8) * FRAME_WIDTH;
+        const uint8_t *b;
+        uint8_t *o = out + p * FRAME_WIDTH;
+
+        if (shift == 0) {
+            memcpy(o, a, FRAME_WIDTH);
+            continue;
+        }
+        q++;
+        b = q < FRAME_HEIGHT / 8 ? from + q * FRAME_WIDTH : to + (q - FRAME_HEIGHT / 8) * FRAME_WIDTH;
+        for (int c = 0; c < FRAME_WIDTH; c++)
+            o[c] = OLED_BYTE_UP(a[c], shift) | OLED_BYTE_DOWN(b[c], 8 - shift);
+    }
+}
+
+/**
+ * @Description: 溶解：Bayer 序号小于 level 的点取新界面
+ * @return {*}
+ */
+static void compose_fade(const uint8_t *from, const uint8_t *to, int level, uint8_t *out) {
+    uint8_t mask[FRAME_BUFFER_SIZE];
+
+    // 掩码只和列号除以 8 的余数有关，每页相同
+    for (int c = 0; c < 8; c++) {
+        mask[c] = 0;
+        for (int r = 0; r < 8; r++)
+            if (bayer_index[r][c] < level)
+                mask[c] |= OLED_PIXEL_MASK(r);
+    }
+    for (int i = 8; i < FRAME_BUFFER_SIZE; i++)
+        mask[i] = mask[i % 8];
+    memcpy(out, from, FRAME_BUFFER_SIZE);
+    OLED_MergeMasked(out, to, mask, FRAME_BUFFER_SIZE);
+}
+
+/**
+ * @Description: 合成一帧过渡画面写入帧缓冲
+ * @param {int} type: 切换方式 TransitionType
+ * @param {const uint8_t} *from: 旧界面
+ * @param {const uint8_t} *to: 新界面
+ * @param {int} step: 当前帧（1 ~ steps，steps 时完全是新界面）
+ * @param {int} steps: 总帧数
+ * @param {uint8_t} *frame_buffer: 帧缓冲
+ * @param {Rect} *damage: 输出与上一帧相比变化的区域
+ * @param {int} max_damage: 脏矩形数组大小
+ * @return {*} 脏矩形个数
+ */
+int transition_frame(int type, const uint8_t *from, const uint8_t *to, int step, int steps,
+                     uint8_t *frame_buffer, Rect *damage, int max_damage) {
+    uint8_t out[FRAME_BUFFER_SIZE];
+    int count;
+
+    if (step >= steps || type == TRANSITION_NONE)
+        memcpy(out, to, FRAME_BUFFER_SIZE);
+    else if (type == TRANSITION_SLIDE)
+        compose_slide(from, to, FRAME_WIDTH * step / steps, out);
+    else if (type == TRANSITION_WIPE)
+        compose_wipe(from, to, FRAME_WIDTH * step / steps, out);
+    else if (type == TRANSITION_PUSH)
+        compose_push(from, to, FRAME_HEIGHT * step / steps, out);
+    else
+        compose_fade(from, to, 64 * step / steps, out);
+
+    // 只发送与屏幕上不同的部分（擦除时只有移动的那几列）
+    count = OLED_DiffDamage(frame_buffer, out, damage, max_damage);
+    memcpy(frame_buffer, out, FRAME_BUFFER_SIZE);
+    return count;
+}
@@ -0,0 +1,338 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 14:02:31
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 14:02:31
+ * @Description: 保留模式控件，记住上次渲染的内容，只重绘变化的部分并输出脏矩形
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include "widget.h"
+
+/**
+ * @Description: 设置标签文本
+ * @param {Widget} *w: 控件
+ * @param {const char} *text: 文本
+ * @return {*} 1 文本变化，0 没有变化
+ */
+int widget_set_text(Widget *w, const char *text) {
+    if (strncmp(w->text, text, sizeof(w->text) - 1) == 0)
+        return 0;
+    snprintf(w->text, sizeof(w->text), "%s", text);
+    return 1;
+}
+
+/**
+ * @Description: 设置数字/进度条数值
+ * @param {Widget} *w: 控件
+ * @param {int} value: 数值
+ * @return {*} 1 数值变化，0 没有变化
+ */
+int widget_set_value(Widget *w, int value) {
+    if (w->value == value)
+        return 0;
+    w->value = value;
+    return 1;
+}
+
+/**
+ * @Description: 设置图标
+ * @param {Widget} *w: 控件
+ * @param {const uint8_t} *icon: 页式点阵
+ * @return {*} 1 图标变化，0 没有变化
+ */
+int widget_set_icon(Widget *w, const uint8_t *icon) {
+    if (w->icon == icon)
+        return 0;
+    w->icon = icon;
+    return 1;
+}
+
+/**
+ * @Description: 标记控件需要完整重绘（切换页面或清屏之后）
+ * @param {Widget} *widgets: 控件数组
+ * @param {int} count: 控件个数
+ * @return {*}
+ */
+void widget_invalidate(Widget *widgets, int count) {
+    for (int i = 0; i < count; i++)
+        widgets[i].rendered = 0;
+}
+
+/**
+ * @Description: 判断文本是否全是 ASCII（ASCII 字符等宽，可以逐字比较）
+ * @param {const char} *s: 文本
+ * @return {*}
+ */
+static int is_ascii(const char *s) {
+    for (; *s; s++)
+        if ((uint8_t)*s >= 0x80)
+            return 0;
+    return 1;
+}
+
+/**
+ * @Description: 渲染含有非 ASCII 字符的文本，字宽不固定，文本变化时整体重绘
+ *               只画在控件所在的一行内，超出控件宽度（未设置时到绘制目标右边缘）的部分裁掉
+ * @param {Surface} *s: 绘制目标
+ * @param {Widget} *w: 控件
+ * @param {const char} *text: 要显示的文本
+ * @param {Rect} *damage: 输出脏矩形
+ * @return {*} 1 有变化，0 无变化
+ */
+static int render_text_utf8(Surface *s, Widget *w, const char *text, Rect *damage) {
+    int max_w = w->w > 0 ? w->w : s->width - w->x;
+    int width;
+
+    if (w->rendered && strcmp(w->shown, text) == 0)
+        return 0;
+
+    if (w->rendered && w->shown_width > 0)
+        OLED_Fill(s, w->x, w->y, w->x + w->shown_width - 1, w->y + w->font - 1, 0);
+    width = OLED_ShowStringClip(s, w->x, w->y, (const uint8_t *)text, w->font, max_w);
+
+    damage->x0 = w->x;
+    damage->x1 = w->x + (width > w->shown_width ? width : w->shown_width) - 1;
+    damage->y0 = w->y;
+    damage->y1 = w->y + w->font - 1;
+    snprintf(w->shown, sizeof(w->shown), "%s", text);
+    w->shown_width = width;
+    return damage->x1 >= damage->x0;
+}
+
+/**
+ * @Description: 渲染文本，只重绘与上次不同的字符（定宽字体）
+ * @param {Surface} *s: 绘制目标
+ * @param {Widget} *w: 控件
+ * @param {const char} *text: 要显示的文本
+ * @param {Rect} *damage: 输出脏矩形
+ * @return {*} 1 有变化，0 无变化
+ */
+static int render_text(Surface *s, Widget *w, const char *text, Rect *damage) {
+    int cw = w->font / 2;
+    int old_len = strlen(w->shown);
+    int new_len = strlen(text);
+    int len = old_len > new_len ? old_len : new_len;
+    int first = 0, last = len - 1;
+
+    if (!is_ascii(text) || !is_ascii(w->shown))
+        return render_text_utf8(s, w, text, damage);
+
+    if (w->rendered) {
+        // 找出第一个和最后一个不同的字符
+        while (first < len && (first < old_len) == (first < new_len) &&
+               (first >= new_len || w->shown[first] == text[first]))
+            first++;
+        if (first == len)
+            return 0;
+        while (last > first && (last < old_len) == (last < new_len) &&
+               (last >= new_len || w->shown[last] == text[last]))
+            last--;
+    } else if (len == 0) {
+        return 0;
+    }
+
+    for (int i = first; i <= last; i++) {
+        int cx = w->x + i * cw;
+        if (i < new_len && text[i] >= ' ' && text[i] <= '~')
+            OLED_ShowChar(s, cx, w->y, text[i], w->font, 1);
+        else
+            OLED_Fill(s, cx, w->y, cx + cw - 1, w->y + w->font - 1, 0); // 文本变短，清除多余的字符
+    }
+
+    damage->x0 = w->x + first * cw;
+    damage->x1 = w->x + (last + 1) * cw - 1;
+    damage->y0 = w->y;
+    damage->y1 = w->y + w->font - 1;
+    snprintf(w->shown, sizeof(w->shown), "%s", text);
+    w->shown_width = new_len * cw;
+    return 1;
+}
+
+/**
+ * @Description: 渲染进度条，只填充变化的列
+ * @param {Surface} *s: 绘制目标
+ * @param {Widget} *w: 控件
+ * @param {Rect} *damage: 输出脏矩形
+ * @return {*} 1 有变化，0 无变化
+ */
+static int render_bar(Surface *s, Widget *w, Rect *damage) {
+    int inner = w->w - 2;   // 边框内的宽度
+    int value = w->value < 0 ? 0 : (w->value > 100 ? 100 : w->value);
+    int new_fill = inner * value / 100;
+    int old_fill = w->shown_value;
+
+    if (!w->rendered) {
+        OLED_DrawRect(s, w->x, w->y, w->x + w->w - 1, w->y + w->h - 1, 1);
+        OLED_Fill(s, w->x + 1, w->y + 1, w->x + w->w - 2, w->y + w->h - 2, 0);
+        old_fill = 0;
+        damage->x0 = w->x;
+        damage->x1 = w->x + w->w - 1;
+    } else if (new_fill == old_fill) {
+        return 0;
+    } else {
+        damage->x0 = w->x + 1 + (old_fill < new_fill ? old_fill : new_fill);
+        damage->x1 = w->x + (old_fill > new_fill ? old_fill : new_fill);
+    }
+
+    if (new_fill > old_fill)
+        OLED_Fill(s, w->x + 1 + old_fill, w->y + 1, w->x + new_fill, w->y + w->h - 2, 1);
+    else if (new_fill < old_fill)
+        OLED_Fill(s, w->x + 1 + new_fill, w->y + 1, w->x + old_fill, w->y + w->h - 2, 0);
+
+    damage->y0 = w->y;
+    damage->y1 = w->y + w->h - 1;
+    w->shown_value = new_fill;
+    return 1;
+}
+
+/**
+ * @Description: 渲染图标，图标变化时整体重绘
+ * @param {Surface} *s: 绘制目标
+ * @param {Widget} *w: 控件
+ * @param {Rect} *damage: 输出脏矩形
+ * @return {*} 1 有变化，0 无变化
+ */
+static int render_icon(Surface *s, Widget *w, Rect *damage) {
+    if (w->rendered && w->icon == w->shown_icon)
+        return 0;
+
+    if (w->icon)
+        OLED_BlitColumns(s, w->x, w->y, w->icon, w->w, w->h, 1, w->w, 1);
+    else
+        OLED_Fill(s, w->x, w->y, w->x + w->w - 1, w->y + w->h - 1, 0);
+
+    damage->x0 = w->x;
+    damage->x1 = w->x + w->w - 1;
+    damage->y0 = w->y;
+    damage->y1 = w->y + w->h - 1;
+    w->shown_icon = w->icon;
+    return 1;
+}
+
+/**
+ * @Description: 采样值转换为图表中的 y 坐标
+ * @param {Widget} *w: 控件
+ * @param {int} value: 采样值
+ * @return {*}
+ */
+static int graph_y(const Widget *w, int value) {
+    long long v = value;
+
+    if (v < w->lo) v = w->lo;
+    if (v > w->hi) v = w->hi;
+    return w->y + w->h - 1 - (int)((v - w->lo) * (w->h - 1) / (w->hi - w->lo));
+}
+
+/**
+ * @Description: 渲染滚动图表，有新采样时整体左移，只画新的几列
+ * @param {Surface} *s: 绘制目标
+ * @param {Widget} *w: 控件
+ * @param {Rect} *damage: 输出脏矩形
+ * @return {*} 1 有变化，0 无变化
+ */
+static int render_graph(Surface *s, Widget *w, Rect *damage) {
+    SampleHistory *h = sampler_history(w->source);
+    unsigned head, n;
+
+    if (!h || w->hi <= w->lo)
+        return 0;
+    head = atomic_load_explicit(&h->head, memory_order_acquire);
+    n = head - w->drawn;
+
+    if (!w->rendered || n >= (unsigned)w->w) {
+        // 第一次显示或落后超过一屏：用历史记录重画整个图表
+        n = head < (unsigned)w->w ? head : (unsigned)w->w;
+        OLED_Fill(s, w->x, w->y, w->x + w->w - 1, w->y + w->h - 1, 0);
+        damage->x0 = w->x;
+    } else if (n == 0) {
+        return 0;
+    } else {
+        OLED_ShiftColumns(s, w->x, w->y, w->x + w->w - 1, w->y + w->h - 1, -n);
+        damage->x0 = w->x;
+    }
+
+    for (unsigned k = head - n; k != head; k++) {
+        int col = w->x + w->w - (int)(head - k);
+        int y = graph_y(w, history_at(h, k));
+
+        if (w->type == WIDGET_BARGRAPH) {
+            OLED_DrawVLine(s, col, y, w->y + w->h - 1, 1);
+        } else {
+            // 与前一个点连成竖线，折线不会断开
+            int prev = (k != 0 && head - k < SAMPLER_HISTORY) ? graph_y(w, history_at(h, k - 1)) : y;
+            OLED_DrawVLine(s, col, prev, y, 1);
+        }
+    }
+
+    damage->x1 = w->x + w->w - 1;
+    damage->y0 = w->y;
+    damage->y1 = w->y + w->h - 1;
+    w->drawn = head;
+    return 1;
+}
+
+/**
+ * @Description: 重绘数值或内容发生变化的控件
+ * @param {Surface} *s: 绘制目标
+ * @param {Widget} *widgets: 控件数组
+ * @param {int} count: 控件个数
+ * @param {Rect} *damage: 输出脏矩形数组
+ * @param {int} max_damage: 脏矩形数组大小，不够时合并到最后一个
+ * @return {*} 脏矩形个数
+ */
+int widget_render(Surface *s, Widget *widgets, int count, Rect *damage, int max_damage) {
+    int n = 0;
+    char num[WIDGET_TEXT_MAX];
+
+    for (int i = 0; i < count; i++) {
+        Widget *w = &widgets[i];
+        Rect r;
+        int changed = 0;
+
+        switch (w->type) {
+            case WIDGET_LABEL:
+                changed = render_text(s, w, w->text, &r);
+                break;
+            case WIDGET_NUMBER:
+                snprintf(num, sizeof(num), "%*d", w->digits, w->value);
+                changed = render_text(s, w, num, &r);
+                break;
+            case WIDGET_BAR:
+                changed = render_bar(s, w, &r);
+                break;
+            case WIDGET_ICON:
+                changed = render_icon(s, w, &r);
+                break;
+            case WIDGET_SPARKLINE:
+            case WIDGET_BARGRAPH:
+                changed = render_graph(s, w, &r);
+                break;
+            default:
+                break;
+        }
+        w->rendered = 1;
+        if (!changed || max_damage <= 0)
+            continue;
+
+        // 裁剪到画布范围内（文本可能超出右边界）
+        if (r.x0 < 0) r.x0 = 0;
+        if (r.y0 < 0) r.y0 = 0;
+        if (r.x1 > s->width - 1) r.x1 = s->width - 1;
+        if (r.y1 > s->height - 1) r.y1 = s->height - 1;
+        if (r.x0 > r.x1 || r.y0 > r.y1)
+            continue;
+
+        if (n < max_damage) {
+            damage[n++] = r;
+        } else {
+            // 数组已满，合并到最后一个矩形
+            Rect *m = &damage[max_damage - 1];
+            if (r.x0 < m->x0) m->x0 = r.x0;
+            if (r.y0 < m->y0) m->y0 = r.y0;
+            if (r.x1 > m->x1) m->x1 = r.x1;
+            if (r.y1 > m->y1) m->y1 = r.y1;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,238 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 15:48:12
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 15:48:12
+ * @Description: BDF 点阵字体转换工具，输出 spi_oled_app 使用的 .olf 字库
+ *               GB2312 编码的 BDF（CHARSET_REGISTRY GB2312.*）通过 iconv 转换为 Unicode 码位
+ *               用法：bdf2olf <input.bdf> <output.olf>
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <iconv.h>
+
+#include "font.h"
+
+/* 字形最大宽度（索引中字宽只有一个字节） */
+#define MAX_WIDTH 255
+
+/* 转换过程中的一个字 */
+typedef struct {
+    uint32_t code;          // Unicode 码位
+    uint8_t width;          // 字宽
+    uint8_t *bitmap;        // 页式字模，pages * width 字节
+} Glyph;
+
+static Glyph *glyphs;
+static int count, capacity;
+static int height, ascent, pages;
+static iconv_t gb2312 = (iconv_t)-1;
+
+/**
+ * @Description: GB2312 区位码转换为 Unicode
+ * @param {int} enc: BDF 中的编码（如 0x3021 或 0xB0A1）
+ * @return {*} Unicode 码位，无法转换时返回 0
+ */
+static uint32_t gb2312_to_unicode(int enc) {
+    char in[2] = { (char)((enc >> 8) | 0x80), (char)((enc & 0xFF) | 0x80) };
+    uint32_t out = 0;
+    char *ip = in, *op = (char *)&out;
+    size_t il = sizeof(in), ol = sizeof(out);
+
+    if (enc < 0x80)
+        return enc;
+    iconv(gb2312, NULL, NULL, NULL, NULL); // 复位转换状态
+    if (iconv(gb2312, &ip, &il, &op, &ol) == (size_t)-1)
+        return 0;
+    return out;
+}
+
+/**
+ * @Description: 十六进制字符转换为数值
+ * @param {char} c: 字符
+ * @return {*} 0~15，非法字符返回 -1
+ */
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @Description: 读取一个字（STARTCHAR 到 ENDCHAR）并转换为页式字模
+ * @param {FILE} *in: BDF 文件
+ * @return {*} 0 成功，-1 文件格式错误
+ */
+static int read_glyph(FILE *in) {
+    char line[1024];
+    int enc = -1, dwidth = 0, bw = 0, bh = 0, bx = 0, by = 0, row = 0, in_bitmap = 0;
+    uint8_t *bitmap = NULL;
+
+    while (fgets(line, sizeof(line), in)) {
+        if (in_bitmap && strncmp(line, "ENDCHAR", 7) != 0) {
+            // 每行一个十六进制串，最高位是最左边的像素
+            int y = ascent - (by + bh) + row++;
+            if (!bitmap || y < 0 || y >= height)
+                continue;
+            for (int c = 0; c < bw; c++) {
+                int v = hex_value(line[c / 4]);
+                int x = bx + c;
+                if (v < 0)
+                    break;
+                if ((v & (8 >> (c % 4))) && x >= 0 && x < dwidth)
+                    bitmap[(y / 8) * dwidth + x] |= OLED_PIXEL_MASK(y);
+            }
+        } else if (sscanf(line, "ENCODING %d", &enc) == 1) {
+        } else if (sscanf(line, "DWIDTH %d", &dwidth) == 1) {
+        } else if (sscanf(line, "BBX %d %d %d %d", &bw, &bh, &bx, &by) == 4) {
+        } else if (strncmp(line, "BITMAP", 6) == 0) {
+            in_bitmap = 1;
+            if (dwidth <= 0)
+                dwidth = bw + (bx > 0 ? bx : 0);
+            if (dwidth > MAX_WIDTH)
+                dwidth = MAX_WIDTH;
+            if (dwidth > 0)
+                bitmap = calloc(pages, dwidth);
+        } else if (strncmp(line, "ENDCHAR", 7) == 0) {
+            break;
+        }
+    }
+
+    if (!in_bitmap) {
+        free(bitmap);
+        return -1;
+    }
+    if (gb2312 != (iconv_t)-1 && enc >= 0)
+        enc = gb2312_to_unicode(enc);
+    if (enc <= 0 || !bitmap) { // ENCODING -1 或无法转换的字丢弃
+        free(bitmap);
+        return 0;
+    }
+
+    if (count == capacity) {
+        capacity = capacity ? capacity * 2 : 1024;
+        glyphs = realloc(glyphs, capacity * sizeof(Glyph));
+        if (!glyphs) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    glyphs[count++] = (Glyph){ .code = enc, .width = dwidth, .bitmap = bitmap };
+    return 0;
+}
+
+/**
+ * @Description: 按码位排序
+ * @return {*}
+ */
+static int compare_glyph(const void *a, const void *b) {
+    uint32_t ca = ((const Glyph *)a)->code, cb = ((const Glyph *)b)->code;
+    return ca < cb ? -1 : ca > cb;
+}
+
+/**
+ * @Description: 写出 .olf 字库
+ * @param {const char} *path: 输出文件
+ * @return {*} 0 成功，-1 失败
+ */
+static int write_olf(const char *path) {
+    OlfHeader hdr = {
+        .magic = OLF_MAGIC,
+        .version = OLF_VERSION,
+        .height = height,
+        .pages = pages,
+        .count = count,
+        .index_offset = sizeof(OlfHeader),
+        .data_offset = sizeof(OlfHeader) + count * sizeof(OlfGlyph),
+    };
+    uint32_t offset = 0;
+    FILE *out = fopen(path, "wb");
+
+    if (!out) {
+        perror(path);
+        return -1;
+    }
+    fwrite(&hdr, sizeof(hdr), 1, out);
+    for (int i = 0; i < count; i++) {
+        OlfGlyph g = { .code = glyphs[i].code, .offset = offset, .width = glyphs[i].width };
+        fwrite(&g, sizeof(g), 1, out);
+        offset += pages * glyphs[i].width;
+    }
+    for (int i = 0; i < count; i++)
+        fwrite(glyphs[i].bitmap, pages, glyphs[i].width, out);
+    if (fclose(out) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    char line[1024], registry[64];
+    int bbw, bbh, bbx, bby, n;
+    FILE *in;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <input.bdf> <output.olf>\n", argv[0]);
+        return 1;
+    }
+    in = fopen(argv[1], "r");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    ascent = -1;
+    while (fgets(line, sizeof(line), in)) {
+        if (sscanf(line, "FONTBOUNDINGBOX %d %d %d %d", &bbw, &bbh, &bbx, &bby) == 4) {
+            height = bbh;
+            if (ascent < 0)
+                ascent = bbh + bby;
+        } else if (sscanf(line, "FONT_ASCENT %d", &ascent) == 1) {
+        } else if (sscanf(line, "CHARSET_REGISTRY \"%63[^\"]\"", registry) == 1) {
+            if (strncasecmp(registry, "GB2312", 6) == 0) {
+                gb2312 = iconv_open("UTF-32LE", "GB2312");
+                if (gb2312 == (iconv_t)-1) {
+                    perror("iconv_open GB2312");
+                    return 1;
+                }
+            }
+        } else if (strncmp(line, "STARTCHAR", 9) == 0) {
+            if (height <= 0 || height > FRAME_HEIGHT) {
+                fprintf(stderr, "%s: unsupported font height %d\n", argv[1], height);
+                return 1;
+            }
+            pages = (height + 7) / 8;
+            if (read_glyph(in) < 0) {
+                fprintf(stderr, "%s: truncated glyph\n", argv[1]);
+                return 1;
+            }
+        }
+    }
+    fclose(in);
+
+    // 排序并去掉重复的码位，app 中二分查找
+    qsort(glyphs, count, sizeof(Glyph), compare_glyph);
+    n = 0;
+    for (int i = 0; i < count; i++) {
+        if (n > 0 && glyphs[n - 1].code == glyphs[i].code) {
+            free(glyphs[i].bitmap);
+            continue;
+        }
+        glyphs[n++] = glyphs[i];
+    }
+    count = n;
+
+    if (write_olf(argv[2]) < 0)
+        return 1;
+    printf("%s: %d glyphs, height %d\n", argv[2], count, height);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 10:12:05
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 10:12:05
+ * @Description: 字模生成工具，在构建时把 oledfont.h 中的逐列式字模
+ *               转换为与帧缓冲布局一致的页式字模（每页一行连续字节），输出到标准输出
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include <stdio.h>
+
+#include "page.h"
+#include "oledfont.h"
+
+/**
+ * @Description: 源字模字节转换为帧缓冲字节（源字模最高位在上，帧缓冲最低位在上）
+ * @param {uint8_t} b: 源字模字节
+ * @return {*}
+ */
+static uint8_t native_byte(uint8_t b) {
+    return OLED_ReverseByte(b);
+}
+
+/**
+ * @Description: 输出一套字模
+ * @param {const char} *name: 字体名
+ * @param {const uint8_t} *src: 逐列式字模，每个字 bytes_per_glyph 字节
+ * @param {int} count: 字符个数
+ * @param {int} first: 第一个字符的编码
+ * @param {int} height: 字高
+ * @param {int} width: 字宽
+ * @return {*}
+ */
+static void emit_font(const char *name, const uint8_t *src, int count, int first, int height, int width) {
+    int pages = (height + 7) / 8;
+    int bytes_per_glyph = pages * width;
+
+    printf("/* %s: %dx%d, %d glyphs */\n", name, width, height, count);
+    printf("static const uint8_t %s_data[%d][%d][%d] = {\n", name, count, pages, width);
+    for (int g = 0; g < count; g++) {
+        const uint8_t *glyph = src + g * bytes_per_glyph;
+        printf("{");
+        for (int p = 0; p < pages; p++) {
+            // 最后一页可能不足 8 行，多余的位清零
+            int rows = height - p * 8;
+            uint8_t mask = rows >= 8 ? 0xFF : OLED_ReverseByte(OLED_TOP_ROWS(rows)); // 源字模位序
+            printf("{");
+            for (int c = 0; c < width; c++)
+                printf("0x%02X%s", native_byte(glyph[c * pages + p] & mask), c + 1 < width ? "," : "");
+            printf("}%s", p + 1 < pages ? "," : "");
+        }
+        if (first >= ' ' && first + g <= '~' && first + g != '\\' && first + g != '*')
+            printf("},/* '%c' */\n", first + g);
+        else
+            printf("},/* %d */\n", first + g);
+    }
+    printf("};\n");
+
+    // 宽度表，字符串排版按每个字的宽度前进
+    printf("static const uint8_t %s_widths[%d] = {", name, count);
+    for (int g = 0; g < count; g++)
+        printf("%s%d", g ? "," : "", width);
+    printf("};\n");
+
+    printf("static const FontStrip %s = { %d, %d, %d, %d, %d, %s_widths, &%s_data[0][0][0] };\n\n",
+           name, height, pages, width, first, count, name, name);
+}
+
+int main(void) {
+    printf("/* 由 tools/fontgen.c 生成，请勿手动修改 */\n");
+    printf("#ifndef _FONT_STRIPS_H_\n#define _FONT_STRIPS_H_\n\n");
+    emit_font("font_1206", &asc2_1206[0][0], 95, ' ', 12, 6);
+    emit_font("font_1608", &asc2_1608[0][0], 95, ' ', 16, 8);
+    emit_font("font_2412", &asc2_2412[0][0], 95, ' ', 24, 12);
+    emit_font("font_chinese16", &Chinese_Text[0][0], 6, 0, 16, 16);
+    printf("#endif\n");
+    return 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 19:58:37
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 19:58:37
+ * @Description: 图片/视频转换工具，把 PGM 图片序列或 ffmpeg 输出的原始帧（灰度/RGB565/RGB24/RGBA/单色）转换为帧缓冲格式
+ *               输出 .ola 动画（XOR 游程差分）或原始帧
+ *               ffmpeg -i in.mp4 -vf scale=128:64 -f rawvideo -pix_fmt gray - | img2oled -R 128x64 -o out.ola -
+ *               ffmpeg -i in.mp4 -f rawvideo -pix_fmt rgb565le - | img2oled -R 320x240 -P rgb565 -o out.ola -
+ *               ffmpeg -i in.mp4 -f image2pipe -vcodec pgm - | img2oled -o out.ola -
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include <unistd.h>
+#include <time.h>
+
+#include "ola_writer.h"
+#include "pixconv.h"
+
+/* 命令行参数 */
+static PixConfig cfg = { .dither = PIX_FLOYD_STEINBERG, .threshold = 127 };
+static int raw_w, raw_h;        // 原始帧的尺寸，0 表示输入为 PGM
+static int raw_format = PIX_FMT_GRAY8; // 原始帧的像素格式
+static int scalar;              // 使用标量实现
+static int compare;             // 同时运行 SIMD 和标量实现，比较输出
+static long mismatches;         // 比较时不一致的字节数
+
+/* 输入帧缓冲（灰度）和原始帧缓冲 */
+static uint8_t *src, *raw_buf;
+static size_t src_cap, raw_buf_cap;
+
+/**
+ * @Description: 显示用法
+ * @param {const char} *name: 程序名
+ * @return {*}
+ */
+static void usage(const char *name) {
+    fprintf(stderr,
+        "Usage: %s [options] <input>...   (input '-' reads stdin)\n"
+        "  -o <file.ola>       Write an animation (XOR-delta/RLE frames)\n"
+        "  -r <file.bin>       Write raw native frames (1024 bytes each)\n"
+        "  -R <WxH>            Inputs are raw frames of this size (default: PGM)\n"
+        "  -P <format>         Raw frame format: gray8, rgb565, rgb24, rgba, mono (default: gray8)\n"
+        "  -d <threshold|ordered|fs>  Dithering (default: fs)\n"
+        "  -t <0-255>          Threshold (default: 127)\n"
+        "  -s <0-255>          Temporal stability: hysteresis against the previous frame (default: 0)\n"
+        "  -f <fps>            Frame rate stored in the animation (default: 30)\n"
+        "  -k <n>              Force a keyframe every n frames (default: 0, never)\n"
+        "  -S                  Use the scalar kernels\n"
+        "  -C                  Run the SIMD and scalar kernels on every frame and compare\n", name);
+}
+
+/**
+ * @Description: 读取 PGM 头中的一个整数，跳过空白和注释
+ * @param {FILE} *in: 输入
+ * @param {int} *value: 输出
+ * @return {*} 0 成功，-1 失败
+ */
+static int pgm_int(FILE *in, int *value) {
+    int c;
+
+    while ((c = getc(in)) != EOF) {
+        if (c == '#') {
+            while ((c = getc(in)) != EOF && c != '\n')
+                ;
+        } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            break;
+        }
+    }
+    if (c == EOF)
+        return -1;
+    ungetc(c, in);
+    return fscanf(in, "%d", value) == 1 ? 0 : -1;
+}
+
+/**
+ * @Description: 确保缓冲足够大
+ * @param {uint8_t} **buf: 缓冲
+ * @param {size_t} *cap: 缓冲大小
+ * @param {size_t} size: 需要的大小
+ * @return {*}
+ */
+static void reserve(uint8_t **buf, size_t *cap, size_t size) {
+    if (size <= *cap)
+        return;
+    *buf = realloc(*buf, size);
+    if (!*buf) {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+    }
+    *cap = size;
+}
+
+/**
+ * @Description: 比较 SIMD 和标量实现的输出，累计不一致的字节数
+ * @return {*}
+ */
+static void check(const uint8_t *a, const uint8_t *b, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        mismatches += a[i] != b[i];
+}
+
+/**
+ * @Description: 读取下一帧
+ * @param {FILE} *in: 输入
+ * @param {int} *w: 输出宽度
+ * @param {int} *h: 输出高度
+ * @return {*} 1 读到一帧，0 输入结束，-1 格式错误
+ */
+static int read_frame(FILE *in, int *w, int *h) {
+    int c1, c2, maxval;
+
+    if (raw_w) {
+        size_t row = pixconv_row_bytes(raw_format, raw_w);
+
+        *w = raw_w;
+        *h = raw_h;
+        reserve(&src, &src_cap, (size_t)raw_w * raw_h);
+        if (raw_format == PIX_FMT_GRAY8)
+            return fread(src, (size_t)raw_w * raw_h, 1, in) == 1;
+
+        // 其他格式先逐行转换为灰度，再缩放和二值化
+        reserve(&raw_buf, &raw_buf_cap, row * raw_h);
+        if (fread(raw_buf, row * raw_h, 1, in) != 1)
+            return 0;
+        if (scalar)
+            pixconv_to_gray_scalar(raw_buf, row, raw_format, raw_w, raw_h, src, raw_w);
+        else
+            pixconv_to_gray(raw_buf, row, raw_format, raw_w, raw_h, src, raw_w);
+        if (compare) {
+            uint8_t *ref = malloc((size_t)raw_w * raw_h);
+            if (!ref) {
+                perror("malloc");
+                exit(EXIT_FAILURE);
+            }
+            pixconv_to_gray_scalar(raw_buf, row, raw_format, raw_w, raw_h, ref, raw_w);
+            check(src, ref, (size_t)raw_w * raw_h);
+            free(ref);
+        }
+        return 1;
+    }
+
+    // 一个文件（或管道）中可以连续存放多张 PGM
+    c1 = getc(in);
+    while (c1 == ' ' || c1 == '\n' || c1 == '\r' || c1 == '\t')
+        c1 = getc(in);
+    if (c1 == EOF)
+        return 0;
+    c2 = getc(in);
+    if (c1 != 'P' || c2 != '5' || pgm_int(in, w) < 0 || pgm_int(in, h) < 0 ||
+        pgm_int(in, &maxval) < 0 || maxval <= 0 || maxval > 255 || *w <= 0 || *h <= 0)
+        return -1;
+    getc(in); // 头和数据之间的一个空白
+    reserve(&src, &src_cap, (size_t)*w * *h);
+    if (fread(src, (size_t)*w * *h, 1, in) != 1)
+        return -1;
+    if (maxval != 255)
+        for (size_t i = 0; i < (size_t)*w * *h; i++)
+            src[i] = src[i] * 255 / maxval;
+    return 1;
+}
+
+/**
+ * @Description: 按面积平均缩放到屏幕大小
+ * @param {int} w: 输入宽度
+ * @param {int} h: 输入高度
+ * @param {uint8_t} *out: 输出 FRAME_WIDTH x FRAME_HEIGHT 灰度图
+ * @return {*}
+ */
+static void scale_to_screen(int w, int h, uint8_t *out) {
+    if (w == FRAME_WIDTH && h == FRAME_HEIGHT) {
+        memcpy(out, src, FRAME_WIDTH * FRAME_HEIGHT);
+        return;
+    }
+    for (int y = 0; y < FRAME_HEIGHT; y++) {
+        int y0 = y * h / FRAME_HEIGHT, y1 = (y + 1) * h / FRAME_HEIGHT;
+        if (y1 <= y0)
+            y1 = y0 + 1;
+        for (int x = 0; x < FRAME_WIDTH; x++) {
+            int x0 = x * w / FRAME_WIDTH, x1 = (x + 1) * w / FRAME_WIDTH;
+            unsigned sum = 0;
+            if (x1 <= x0)
+                x1 = x0 + 1;
+            for (int sy = y0; sy < y1; sy++)
+                for (int sx = x0; sx < x1; sx++)
+                    sum += src[(size_t)sy * w + sx];
+            out[y * FRAME_WIDTH + x] = sum / ((y1 - y0) * (x1 - x0));
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    OlaWriter writer = { 0 };
+    uint8_t gray[FRAME_WIDTH * FRAME_HEIGHT];
+    uint8_t frame[FRAME_BUFFER_SIZE], prev[FRAME_BUFFER_SIZE], ref[FRAME_BUFFER_SIZE];
+    const char *ola = NULL, *raw = NULL;
+    FILE *raw_out = NULL;
+    struct timespec t0, t1;
+    int fps = 30, opt, frames = 0, w, h, ret;
+
+    while ((opt = getopt(argc, argv, "o:r:R:P:d:t:s:f:k:SC")) != -1) {
+        switch (opt) {
+            case 'o': ola = optarg; break;
+            case 'r': raw = optarg; break;
+            case 'R':
+                if (sscanf(optarg, "%dx%d", &raw_w, &raw_h) != 2 || raw_w <= 0 || raw_h <= 0) {
+                    fprintf(stderr, "Bad size: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'P':
+                raw_format = pixconv_format_parse(optarg);
+                if (raw_format < 0) {
+                    fprintf(stderr, "Unknown pixel format: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'd':
+                if (strcmp(optarg, "threshold") == 0)
+                    cfg.dither = PIX_THRESHOLD;
+                else if (strcmp(optarg, "ordered") == 0)
+                    cfg.dither = PIX_ORDERED;
+                else if (strcmp(optarg, "fs") == 0)
+                    cfg.dither = PIX_FLOYD_STEINBERG;
+                else {
+                    fprintf(stderr, "Unknown dithering: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 't': cfg.threshold = atoi(optarg); break;
+            case 's': cfg.hysteresis = atoi(optarg); break;
+            case 'f': fps = atoi(optarg); break;
+            case 'k': writer.keyframe_interval = atoi(optarg); break;
+            case 'S': scalar = 1; break;
+            case 'C': compare = 1; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (optind >= argc || (!ola && !raw && !compare) || fps <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (raw && !(raw_out = fopen(raw, "wb"))) {
+        perror(raw);
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = optind; i < argc; i++) {
+        FILE *in = strcmp(argv[i], "-") == 0 ? stdin : fopen(argv[i], "rb");
+        if (!in) {
+            perror(argv[i]);
+            return 1;
+        }
+        while ((ret = read_frame(in, &w, &h)) > 0) {
+            scale_to_screen(w, h, gray);
+            // 第一帧没有上一帧，不做时间稳定滤波
+            if (scalar)
+                pixconv_gray8_scalar(gray, FRAME_WIDTH, frame, frames ? prev : NULL, &cfg);
+            else
+                pixconv_gray8(gray, FRAME_WIDTH, frame, frames ? prev : NULL, &cfg);
+            if (compare) {
+                pixconv_gray8_scalar(gray, FRAME_WIDTH, ref, frames ? prev : NULL, &cfg);
+                check(frame, ref, FRAME_BUFFER_SIZE);
+            }
+            memcpy(prev, frame, FRAME_BUFFER_SIZE);
+
+            if (ola)
+                ola_add_frame(&writer, frame, 1000 / fps);
+            if (raw_out)
+                fwrite(frame, FRAME_BUFFER_SIZE, 1, raw_out);
+            frames++;
+        }
+        if (ret < 0) {
+            fprintf(stderr, "%s: bad or truncated frame %d\n", argv[i], frames);
+            return 1;
+        }
+        if (in != stdin)
+            fclose(in);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (frames == 0) {
+        fprintf(stderr, "No frames\n");
+        return 1;
+    }
+    if (raw_out && fclose(raw_out) != 0) {
+        perror(raw);
+        return 1;
+    }
+    if (ola && ola_write(&writer, ola) < 0)
+        return 1;
+    fprintf(stderr, "%d frames in %.3f s", frames,
+            (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+    if (ola)
+        fprintf(stderr, ", %s: %zu bytes of frame data (%.1f%% of raw)", ola, writer.data_size,
+                writer.data_size * 100.0 / ((size_t)frames * FRAME_BUFFER_SIZE));
+    fprintf(stderr, "\n");
+    if (compare) {
+        fprintf(stderr, "SIMD vs scalar: %ld mismatched bytes\n", mismatches);
+        return mismatches ? 1 : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 18:40:26
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 18:40:26
+ * @Description: 把帧缓冲格式的原始帧（每帧 1024 字节）打包为 .ola 动画
+ *               用法：mkola [-f fps] [-k keyframe_interval] <output.ola> <frames.bin>...
+ *               每个输入文件可以包含多帧，依次连接
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include <unistd.h>
+
+#include "ola_writer.h"
+
+int main(int argc, char *argv[]) {
+    OlaWriter w = { 0 };
+    uint8_t frame[FRAME_BUFFER_SIZE];
+    int fps = 30, opt;
+
+    while ((opt = getopt(argc, argv, "f:k:")) != -1) {
+        switch (opt) {
+            case 'f':
+                fps = atoi(optarg);
+                break;
+            case 'k':
+                w.keyframe_interval = atoi(optarg);
+                break;
+            default:
+                optind = argc; // 显示用法
+                break;
+        }
+    }
+    if (argc - optind < 2 || fps <= 0) {
+        fprintf(stderr, "Usage: %s [-f fps] [-k keyframe_interval] <output.ola> <frames.bin>...\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = optind + 1; i < argc; i++) {
+        FILE *in = fopen(argv[i], "rb");
+        if (!in) {
+            perror(argv[i]);
+            return 1;
+        }
+        while (fread(frame, FRAME_BUFFER_SIZE, 1, in) == 1)
+            ola_add_frame(&w, frame, 1000 / fps);
+        fclose(in);
+    }
+    if (w.count == 0) {
+        fprintf(stderr, "No frames\n");
+        return 1;
+    }
+
+    if (ola_write(&w, argv[optind]) < 0)
+        return 1;
+    printf("%s: %u frames, %zu bytes of frame data\n", argv[optind], w.count, w.data_size);
+    return 0;
+}
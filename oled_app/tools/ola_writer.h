@@ -0,0 +1,171 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 18:40:26
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 18:40:26
+ * @Description: 主机工具共用的 .ola 动画写入，相邻帧编码为 XOR 游程差分，差分不划算时写关键帧
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#ifndef _OLA_WRITER_H_
+#define _OLA_WRITER_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "anim.h"
+
+/* 写入中的动画，帧数据先放在内存中，最后一次写出 */
+typedef struct {
+    OlaFrame *frames;
+    uint8_t *data;
+    size_t data_size, data_cap;
+    uint32_t count, cap;
+    uint8_t prev[FRAME_BUFFER_SIZE];    // 上一帧，用于计算差分
+    int keyframe_interval;              // 每隔多少帧强制写一次关键帧，0 表示不强制
+} OlaWriter;
+
+/**
+ * @Description: 追加帧数据
+ * @param {OlaWriter} *w: 写入器
+ * @param {const uint8_t} *p: 数据
+ * @param {size_t} len: 长度
+ * @return {*}
+ */
+static void ola_append(OlaWriter *w, const uint8_t *p, size_t len) {
+    if (w->data_size + len > w->data_cap) {
+        w->data_cap = (w->data_size + len) * 2;
+        w->data = realloc(w->data, w->data_cap);
+        if (!w->data) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    memcpy(w->data + w->data_size, p, len);
+    w->data_size += len;
+}
+
+/**
+ * @Description: 计算与上一帧的 XOR 游程差分
+ * @param {const uint8_t} *prev: 上一帧
+ * @param {const uint8_t} *cur: 当前帧
+ * @param {uint8_t} *out: 输出，至少 FRAME_BUFFER_SIZE * 2 字节
+ * @return {*} 差分大小
+ */
+static size_t ola_encode_delta(const uint8_t *prev, const uint8_t *cur, uint8_t *out) {
+    size_t n = 0;
+    int pos = 0, skip = 0;
+
+    while (pos < FRAME_BUFFER_SIZE) {
+        int len = 0;
+
+        if (prev[pos] == cur[pos]) {
+            skip++;
+            pos++;
+            continue;
+        }
+        // 跳过超过 255 字节时插入空记录
+        while (skip > 255) {
+            out[n++] = 255;
+            out[n++] = 0;
+            skip -= 255;
+        }
+        // 变化的字节，中间只隔一两个不变字节时并入同一条记录，省去记录头
+        while (pos + len < FRAME_BUFFER_SIZE && len < 255) {
+            if (prev[pos + len] != cur[pos + len])
+                len++;
+            else if (pos + len + 2 < FRAME_BUFFER_SIZE && len + 2 < 255 &&
+                     (prev[pos + len + 1] != cur[pos + len + 1] || prev[pos + len + 2] != cur[pos + len + 2]))
+                len++;
+            else
+                break;
+        }
+        out[n++] = skip;
+        out[n++] = len;
+        for (int i = 0; i < len; i++)
+            out[n++] = prev[pos + i] ^ cur[pos + i];
+        pos += len;
+        skip = 0;
+    }
+    return n;
+}
+
+/**
+ * @Description: 添加一帧
+ * @param {OlaWriter} *w: 写入器
+ * @param {const uint8_t} *frame: 帧缓冲格式的一帧
+ * @param {uint32_t} duration_ms: 显示时长
+ * @return {*}
+ */
+static void ola_add_frame(OlaWriter *w, const uint8_t *frame, uint32_t duration_ms) {
+    uint8_t delta[FRAME_BUFFER_SIZE * 2];
+    size_t n = 0;
+    OlaFrame *f;
+    int key;
+
+    if (w->count == w->cap) {
+        w->cap = w->cap ? w->cap * 2 : 64;
+        w->frames = realloc(w->frames, w->cap * sizeof(OlaFrame));
+        if (!w->frames) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    f = &w->frames[w->count];
+    memset(f, 0, sizeof(*f));
+    f->offset = w->data_size;   // 相对帧数据起点，写出时再加上文件头和索引的大小
+    f->duration_ms = duration_ms;
+
+    // 第一帧和到达间隔的帧写关键帧，差分比整帧还大时也写关键帧
+    key = w->count == 0 || (w->keyframe_interval > 0 && w->count % w->keyframe_interval == 0);
+    if (!key)
+        n = ola_encode_delta(w->prev, frame, delta);
+    if (!key && n < FRAME_BUFFER_SIZE) {
+        f->type = OLA_FRAME_DELTA;
+        f->size = n;
+        ola_append(w, delta, n);
+    } else {
+        f->type = OLA_FRAME_RAW;
+        f->size = FRAME_BUFFER_SIZE;
+        ola_append(w, frame, FRAME_BUFFER_SIZE);
+    }
+    memcpy(w->prev, frame, FRAME_BUFFER_SIZE);
+    w->count++;
+}
+
+/**
+ * @Description: 写出动画文件
+ * @param {OlaWriter} *w: 写入器
+ * @param {const char} *path: 输出文件
+ * @return {*} 0 成功，-1 失败
+ */
+static int ola_write(OlaWriter *w, const char *path) {
+    OlaHeader hdr = {
+        .magic = OLA_MAGIC,
+        .version = OLA_VERSION,
+        .count = w->count,
+        .index_offset = sizeof(OlaHeader),
+    };
+    uint32_t base = sizeof(OlaHeader) + w->count * sizeof(OlaFrame);
+    FILE *out = fopen(path, "wb");
+
+    if (!out) {
+        perror(path);
+        return -1;
+    }
+    fwrite(&hdr, sizeof(hdr), 1, out);
+    for (uint32_t i = 0; i < w->count; i++) {
+        OlaFrame f = w->frames[i];
+        f.offset += base;
+        fwrite(&f, sizeof(f), 1, out);
+    }
+    fwrite(w->data, 1, w->data_size, out);
+    if (fclose(out) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ * @Author: Li RF
+ * @Date: 2026-10-19 22:41:09
+ * @LastEditors: Li RF
+ * @LastEditTime: 2026-10-19 22:41:09
+ * @Description: 显示服务（spi_oled_app --server）的示例客户端，在板子上运行
+ *               申请屏幕上的一个区域，从输入读取整屏原始帧（帧缓冲布局，1024 字节/帧，img2oled -r 的输出），
+ *               把区域内的部分写入共享内存，只提交变化的矩形
+ *               img2oled -R 128x64 -r /dev/stdout - < in.gray | oledlayer -g 64,16,64,32 -p 1 -
+ * Email: 1125962926@qq.com
+ * Copyright (c) 2026 Li RF, All Rights Reserved.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "server.h"
+
+/**
+ * @Description: 显示用法
+ * @param {const char} *name: 程序名
+ * @return {*}
+ */
+static void usage(const char *name) {
+    fprintf(stderr,
+        "Usage: %s -g <x,y,w,h> [options] <input>   (input '-' reads stdin)\n"
+        "  -g <x,y,w,h>        Screen area of the layer\n"
+        "  -p <priority>       Stacking priority, higher is on top (default: 0)\n"
+        "  -o                  Transparent: only set pixels, keep what is underneath\n"
+        "  -f <fps>            Frame rate (default: 0, as fast as the input arrives)\n"
+        "  -S <path>           Server socket (default: %s)\n", name, SERVER_SOCKET_PATH);
+}
+
+/**
+ * @Description: 连接显示服务并申请区域
+ * @param {const char} *path: socket 路径
+ * @param {ServerMsg} *req: SERVER_CREATE 请求，返回时为回复
+ * @param {int} *memfd: 输出共享内存
+ * @return {*} 连接，-1 失败
+ */
+static int layer_connect(const char *path, ServerMsg *req, int *memfd) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } ctrl;
+    struct iovec iov = { .iov_base = req, .iov_len = sizeof(*req) };
+    struct msghdr mh = { .msg_iov = &iov, .msg_iovlen = 1, .msg_control = ctrl.buf, .msg_controllen = sizeof(ctrl.buf) };
+    struct cmsghdr *cm;
+    int sock;
+
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0 || connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror(path);
+        return -1;
+    }
+    if (send(sock, req, sizeof(*req), MSG_NOSIGNAL) != sizeof(*req) || recvmsg(sock, &mh, MSG_CMSG_CLOEXEC) != sizeof(*req)) {
+        fprintf(stderr, "%s: no reply\n", path);
+        close(sock);
+        return -1;
+    }
+    if (req->type != SERVER_REPLY || req->status < 0) {
+        fprintf(stderr, "Create layer: %s\n", strerror(req->type == SERVER_REPLY ? -req->status : EPROTO));
+        close(sock);
+        return -1;
+    }
+    cm = CMSG_FIRSTHDR(&mh);
+    if (!cm || cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_RIGHTS) {
+        fprintf(stderr, "Create layer: no shared memory\n");
+        close(sock);
+        return -1;
+    }
+    memcpy(memfd, CMSG_DATA(cm), sizeof(int));
+    return sock;
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = SERVER_SOCKET_PATH;
+    ServerMsg req = { .type = SERVER_CREATE, .w = 0 };
+    uint8_t frame[FRAME_BUFFER_SIZE];
+    struct timespec next;
+    long period_ns = 0;
+    int x, y, w, h, opt, sock, memfd;
+    long frames = 0, sent = 0;
+    uint8_t *layer;
+    FILE *in;
+
+    while ((opt = getopt(argc, argv, "g:p:of:S:")) != -1) {
+        switch (opt) {
+            case 'g':
+                if (sscanf(optarg, "%d,%d,%d,%d", &x, &y, &w, &h) != 4) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                req.x = x;
+                req.y = y;
+                req.w = w;
+                req.h = h;
+                break;
+            case 'p': req.priority = atoi(optarg); break;
+            case 'o': req.flags |= SERVER_LAYER_OR; break;
+            case 'f': period_ns = atoi(optarg) > 0 ? 1000000000L / atoi(optarg) : 0; break;
+            case 'S': path = optarg; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (req.w <= 0 || optind != argc - 1) {
+        usage(argv[0]);
+        return 1;
+    }
+    in = strcmp(argv[optind], "-") == 0 ? stdin : fopen(argv[optind], "rb");
+    if (!in) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    x = req.x;
+    y = req.y;
+    w = req.w;
+    h = req.h;
+    sock = layer_connect(path, &req, &memfd);
+    if (sock < 0)
+        return 1;
+    layer = mmap(NULL, req.size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    close(memfd);
+    if (layer == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (fread(frame, FRAME_BUFFER_SIZE, 1, in) == 1) {
+        ServerMsg damage = { .type = SERVER_DAMAGE };
+        int x0 = w, x1 = -1, y0 = h, y1 = -1;
+
+        // 区域可以不按页对齐，逐点复制，同时求出变化的范围
+        for (int r = 0; r < h; r++) {
+            int sy = y + r;
+            uint8_t *row = layer + r / 8 * w;
+            uint8_t bit = 1 << (r % 8);
+
+            for (int c = 0; c < w; c++) {
+                uint8_t on = frame[sy / 8 * FRAME_WIDTH + x + c] >> (sy % 8) & 1;
+
+                if (!!(row[c] & bit) == on)
+                    continue;
+                row[c] ^= bit;
+                if (c < x0) x0 = c;
+                if (c > x1) x1 = c;
+                if (r < y0) y0 = r;
+                if (r > y1) y1 = r;
+            }
+        }
+        frames++;
+
+        if (x1 >= 0) {
+            damage.x = x0;
+            damage.y = y0;
+            damage.w = x1 - x0 + 1;
+            damage.h = y1 - y0 + 1;
+            if (send(sock, &damage, sizeof(damage), MSG_NOSIGNAL) < 0) {
+                perror("send");
+                break;
+            }
+            sent++;
+        }
+
+        if (period_ns) {
+            next.tv_nsec += period_ns;
+            while (next.tv_nsec >= 1000000000L) {
+                next.tv_nsec -= 1000000000L;
+                next.tv_sec++;
+            }
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        }
+    }
+    fprintf(stderr, "%ld frames, %ld updates\n", frames, sent);
+
+    munmap(layer, req.size);
+    close(sock);
+    if (in != stdin)
+        fclose(in);
+    return 0;
+}
@@ -19,10 +19,54 @@
 #include <linux/types.h>
 #include <linux/mm.h>
 #include <linux/vmalloc.h>
+#include <linux/mutex.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/uio.h>
+#include <linux/ktime.h>
+#include <linux/hrtimer.h>
+#include <linux/sched.h>
+#include <linux/moduleparam.h>
+#include <linux/firmware.h>
+#include <linux/of.h>
+#include <linux/of_gpio.h>
+#include <linux/platform_device.h>
+#include <linux/i2c.h>
+#include <linux/version.h>
+#include <linux/math64.h>
 
 #include "def_spi_oled.h"
 
 /***************************** oled 设备 ******************************/
+/* 传输接口，SPI（GPIO 模拟）与 I2C 共用脏区域跟踪和命令组包逻辑 */
+struct oled_transport {
+    const char *name;
+    void (*reset)(void);    /* 硬件复位，可为 NULL */
+    void (*restore)(void);  /* 唤醒后恢复总线状态，可为 NULL */
+    /* 连续发送多个命令 */
+    void (*write_cmds)(const uint8_t *cmds, size_t len);
+    /* 发送一个窗口：设置页地址和起始列后写入 len 字节数据 */
+    void (*write_window)(unsigned int hw_page, unsigned int x0, const uint8_t *data, size_t len);
+};
+
+/* I2C 单次传输缓冲：控制字节 + 页/列地址命令 + 一整页数据 */
+#define OLED_I2C_BUF_SIZE (8 + FRAME_WIDTH)
+
+/* 单页的待刷新列范围（闭区间） */
+struct oled_dirty {
+    uint8_t x0;
+    uint8_t x1;
+    bool valid;
+};
+
+/* 运行统计，可通过 cat /dev/spi_oled 查看 */
+struct oled_stats {
+    u64 stream_frames;      /* 帧流已显示的帧数 */
+    u64 stream_late;        /* 晚于预定时刻超过半个周期的帧数（空闲后重新开始的第一帧不计） */
+    u64 resume_count;       /* 唤醒恢复次数 */
+    s64 resume_latency_us;  /* 最近一次唤醒到画面恢复的耗时 */
+};
+
 /* spi_oled 设备结构体 */
 struct spi_oled_device{
     dev_t devid;            /* 设备号 */
@@ -34,10 +78,49 @@ struct spi_oled_device{
     char *frame_buffer;     /* 帧缓冲区 */
     struct oled_gpio_stuct gpio_group; /* gpio 序号 */
     unsigned long gpio_request_flag;   /* gpio 申请标志 */
+    bool gpio_persistent;   /* GPIO 由设备树/模块参数配置，关闭设备文件时不释放 */
+    bool display_on;        /* 显示是否开启 */
+    bool inverted;          /* 是否反相显示 */
+    uint8_t orientation;    /* 显示方向 OLED_ORIENT_* */
+    uint8_t contrast;       /* 当前对比度，唤醒时恢复 */
+    bool suspended;         /* 已进入休眠，等待唤醒恢复 */
+    bool scrolling;         /* 硬件滚动已开启，唤醒时重新下发 scroll_cmds */
+    uint8_t scroll_cmds[9]; /* 最近一次 OLED_OP_SCROLL 的命令序列 */
+    struct mutex lock;      /* 保护帧缓冲传输与命令序列 */
+    struct oled_dirty dirty[FRAME_HEIGHT / 8]; /* 每页待刷新的列范围 */
+    size_t stream_fill;     /* 帧流中当前帧已写入的字节数 */
+    unsigned int open_count; /* 打开设备文件的数量，最后一个关闭时丢弃未写满的帧 */
+    u64 frame_period_ns;    /* 帧流显示周期，0 表示不限速 */
+    ktime_t next_frame;     /* 下一帧允许显示的时刻 */
+    struct oled_stats stats; /* 运行统计 */
+    const struct oled_transport *xfer; /* 当前使用的传输接口 */
+    struct i2c_client *client;  /* I2C 屏幕，SPI 屏幕时为 NULL */
+    uint8_t i2c_buf[OLED_I2C_BUF_SIZE]; /* I2C 发送缓冲 */
 };
 struct spi_oled_device spi_oled_dev; /* oled 设备 */
 size_t buffer_size; /* 帧缓冲区大小（可能会被修正，所以使用全局变量） */
 
+/* 帧流默认帧率，可通过 IOCTL_OLED_SET_FPS 修改 */
+static unsigned int stream_fps = 30;
+module_param(stream_fps, uint, 0444);
+MODULE_PARM_DESC(stream_fps, "Default frame rate of write/splice frame streams (0 = unpaced)");
+
+/* 初始显示方向，OLED_ORIENT_* 组合（1 水平镜像，2 垂直镜像，3 旋转 180 度） */
+static unsigned int orientation;
+module_param(orientation, uint, 0444);
+MODULE_PARM_DESC(orientation, "Initial orientation: bit0 flip horizontally, bit1 flip vertically (3 = rotate 180)");
+
+/* 加载模块时直接指定引脚，顺序与 struct oled_gpio_stuct 相同 */
+static int gpios[PIN_NUM];
+static int gpios_num;
+module_param_array(gpios, int, &gpios_num, 0444);
+MODULE_PARM_DESC(gpios, "Panel GPIOs scl,mosi,res,dc; initialize the panel at load time");
+
+/* 开机画面固件（1024 字节原始帧），为空或加载失败时使用内置画面 */
+static char *splash = "";
+module_param(splash, charp, 0444);
+MODULE_PARM_DESC(splash, "Splash firmware name (raw 1024-byte frame), built-in splash if empty");
+
 /***************************** spi 接口 ******************************/
 /**
  * @Description: 软件模拟 spi 写
@@ -66,23 +149,140 @@ static void spi_write_byte(uint8_t data) {
 }
 
 /**
- * @Description: oled 写字节
- * @param {uint8_t} data: 待写入数据
- * @param {uint8_t} cmd: 命令或数据
+ * @Description: 连续写入多个命令，DC 只切换一次
+ * @param {const uint8_t} *cmds: 命令序列
+ * @param {size_t} len: 命令字节数
  * @return {*}
  */
-static void oled_write_byte(uint8_t data, uint8_t cmd)
+static void oled_spi_write_cmds(const uint8_t *cmds, size_t len)
 {
-    /* DC 引脚，指令或数据 */
-    gpio_set_value(spi_oled_dev.gpio_group.dc_pin, cmd);
-    
-    /* 调用 spi 写字节 */
-    spi_write_byte(data);
-    
-    /* DC 引脚，传输完成保持高 */
+    gpio_set_value(spi_oled_dev.gpio_group.dc_pin, OLED_CMD);
+    for (size_t i = 0; i < len; i++)
+        spi_write_byte(cmds[i]);
     gpio_set_value(spi_oled_dev.gpio_group.dc_pin, GPIO_HIGH);
 }
 
+/**
+ * @Description: 写入一个窗口，地址命令和数据各切换一次 DC
+ * @param {unsigned int} hw_page: 屏幕页号
+ * @param {unsigned int} x0: 起始列
+ * @param {const uint8_t} *data: 数据
+ * @param {size_t} len: 数据字节数
+ * @return {*}
+ */
+static void oled_spi_write_window(unsigned int hw_page, unsigned int x0, const uint8_t *data, size_t len)
+{
+    uint8_t cmds[3];
+
+    cmds[0] = 0xB0 + hw_page;       // 设置页地址（0~7）
+    cmds[1] = 0x00 | (x0 & 0x0F);   // 设置显示位置—列低地址
+    cmds[2] = 0x10 | (x0 >> 4);     // 设置显示位置—列高地址
+    oled_spi_write_cmds(cmds, sizeof(cmds));
+
+    // DC 保持高电平，连续写入数据
+    for (size_t i = 0; i < len; i++)
+        spi_write_byte(data[i]);
+}
+
+/***************************** i2c 接口 ******************************/
+// SSD1306 I2C 每次传输以控制字节开头：0x00 之后全部为命令，0x40 之后全部为数据
+// 0x80 表示只跟一个命令字节，之后还有控制字节，可以把地址命令和数据放在同一次传输中
+#define OLED_I2C_CTRL_CMDS 0x00
+#define OLED_I2C_CTRL_DATA 0x40
+#define OLED_I2C_CTRL_CMD_CONT 0x80
+
+/**
+ * @Description: 发送 I2C 缓冲，适配器不支持原始 I2C 时退化为 SMBus 块写（如 i2c-stub）
+ * @param {size_t} len: 缓冲长度（含首个控制字节）
+ * @return {*}
+ */
+static void oled_i2c_send(size_t len)
+{
+    struct i2c_client *client = spi_oled_dev.client;
+    uint8_t *buf = spi_oled_dev.i2c_buf;
+    int ret;
+
+    if (i2c_check_functionality(client->adapter, I2C_FUNC_I2C)) {
+        struct i2c_msg msg = {
+            .addr = client->addr,
+            .flags = 0,
+            .len = len,
+            .buf = buf,
+        };
+        ret = i2c_transfer(client->adapter, &msg, 1);
+        if (ret != 1)
+            printk_ratelimited(KERN_ERR "%s: i2c transfer failed: %d\n", SPI_OLED_NAME, ret);
+        return;
+    }
+
+    // SMBus 块写：控制字节作为寄存器地址，每块最多 I2C_SMBUS_BLOCK_MAX 字节
+    for (size_t off = 1; off < len; off += I2C_SMBUS_BLOCK_MAX) {
+        size_t n = min_t(size_t, len - off, I2C_SMBUS_BLOCK_MAX);
+
+        ret = i2c_smbus_write_i2c_block_data(client, buf[0], n, buf + off);
+        if (ret < 0) {
+            printk_ratelimited(KERN_ERR "%s: smbus block write failed: %d\n", SPI_OLED_NAME, ret);
+            return;
+        }
+    }
+}
+
+/**
+ * @Description: 连续写入多个命令，每次传输只带一个控制字节
+ * @param {const uint8_t} *cmds: 命令序列
+ * @param {size_t} len: 命令字节数
+ * @return {*}
+ */
+static void oled_i2c_write_cmds(const uint8_t *cmds, size_t len)
+{
+    uint8_t *buf = spi_oled_dev.i2c_buf;
+
+    while (len) {
+        size_t n = min_t(size_t, len, OLED_I2C_BUF_SIZE - 1);
+
+        buf[0] = OLED_I2C_CTRL_CMDS;
+        memcpy(buf + 1, cmds, n);
+        oled_i2c_send(n + 1);
+        cmds += n;
+        len -= n;
+    }
+}
+
+/**
+ * @Description: 写入一个窗口，地址命令与数据合并为一次 I2C 传输
+ * @param {unsigned int} hw_page: 屏幕页号
+ * @param {unsigned int} x0: 起始列
+ * @param {const uint8_t} *data: 数据（不超过一页）
+ * @param {size_t} len: 数据字节数
+ * @return {*}
+ */
+static void oled_i2c_write_window(unsigned int hw_page, unsigned int x0, const uint8_t *data, size_t len)
+{
+    struct i2c_client *client = spi_oled_dev.client;
+    uint8_t *buf = spi_oled_dev.i2c_buf;
+
+    if (!i2c_check_functionality(client->adapter, I2C_FUNC_I2C)) {
+        // SMBus 无法使用 Co 位续传，命令与数据分开发送
+        uint8_t cmds[3] = { 0xB0 + hw_page, 0x00 | (x0 & 0x0F), 0x10 | (x0 >> 4) };
+
+        oled_i2c_write_cmds(cmds, sizeof(cmds));
+        buf[0] = OLED_I2C_CTRL_DATA;
+        memcpy(buf + 1, data, len);
+        oled_i2c_send(len + 1);
+        return;
+    }
+
+    buf[0] = OLED_I2C_CTRL_CMD_CONT;
+    buf[1] = 0xB0 + hw_page;            // 设置页地址（0~7）
+    buf[2] = OLED_I2C_CTRL_CMD_CONT;
+    buf[3] = 0x00 | (x0 & 0x0F);        // 设置显示位置—列低地址
+    buf[4] = OLED_I2C_CTRL_CMD_CONT;
+    buf[5] = 0x10 | (x0 >> 4);          // 设置显示位置—列高地址
+    buf[6] = OLED_I2C_CTRL_DATA;        // 之后全部为数据
+    memcpy(buf + 7, data, len);
+    oled_i2c_send(len + 7);
+}
+
 /***************************** GPIO 配置 ******************************/
 /**
  * @description : 检查 GPIO 是否申请并配置
@@ -145,6 +345,18 @@ static void oled_gpio_free(void){
     
 }
 
+/**
+ * @description : 配置 GPIO 方向和默认电平，唤醒时也会调用
+ * @param : 无
+ * @return : 无
+ */
+static void oled_gpio_set_output(void) {
+    gpio_direction_output(spi_oled_dev.gpio_group.scl_pin, GPIO_HIGH);// 空闲时高电平
+    gpio_direction_output(spi_oled_dev.gpio_group.mosi_pin, GPIO_HIGH);// 空闲时高电平
+    gpio_direction_output(spi_oled_dev.gpio_group.res_pin, GPIO_HIGH);// 初始为高电平。拉低 100ms 后拉高，执行 reset
+    gpio_direction_output(spi_oled_dev.gpio_group.dc_pin, OLED_DATA);// DC 初始为高电平
+}
+
 /**
  * @description : 初始化 GPIO
  * @param : 无
@@ -185,11 +397,7 @@ static int oled_gpio_init(void) {
     }
     set_bit(DC_BIT, &spi_oled_dev.gpio_request_flag);
 
-    // 配置 GPIO 方向，默认电平
-    gpio_direction_output(spi_oled_dev.gpio_group.scl_pin, GPIO_HIGH);// 空闲时高电平
-    gpio_direction_output(spi_oled_dev.gpio_group.mosi_pin, GPIO_HIGH);// 空闲时高电平
-    gpio_direction_output(spi_oled_dev.gpio_group.res_pin, GPIO_HIGH);// 初始为高电平。拉低 100ms 后拉高，执行 reset
-    gpio_direction_output(spi_oled_dev.gpio_group.dc_pin, OLED_DATA);// DC 初始为高电平
+    oled_gpio_set_output();
 
     return 0;
 
@@ -198,49 +406,141 @@ err:
     return ret;
 }
 
-/***************************** OLED 初始化 ******************************/
+/***************************** 传输接口 ******************************/
 /**
- * @description : OLED 初始化
+ * @description : 拉低 RES 引脚 100 ms，再拉高，完成复位
  * @param : 无
  * @return : 无
  */
-static void oled_start_init(void) {
-
-    /* 拉低 RES 引脚 100 ms，再拉高，完成复位 */
+static void oled_spi_reset(void) {
 	gpio_set_value(spi_oled_dev.gpio_group.res_pin, GPIO_LOW);
 	mdelay(100);
 	gpio_set_value(spi_oled_dev.gpio_group.res_pin, GPIO_HIGH);
+}
+
+static const struct oled_transport oled_spi_transport = {
+    .name = "spi",
+    .reset = oled_spi_reset,
+    .restore = oled_gpio_set_output,
+    .write_cmds = oled_spi_write_cmds,
+    .write_window = oled_spi_write_window,
+};
+
+/**
+ * @description : 等待 I2C 屏幕应答：上电后需要一段时间才能接收命令，用关闭显示命令探测
+ * @param : 无
+ * @return : 0 屏幕已应答，否则为最后一次传输的错误码
+ */
+static int oled_i2c_wait_ready(void) {
+    int ret = -ENODEV;
+
+    for (int i = 0; i < 10; i++) {
+        ret = i2c_smbus_write_byte_data(spi_oled_dev.client, OLED_I2C_CTRL_CMDS, 0xAE);
+        if (ret == 0)
+            return 0;
+        msleep(10);
+    }
+    return ret;
+}
+
+/**
+ * @description : 唤醒后等待屏幕重新上电，之后再重放初始化命令
+ * @param : 无
+ * @return : 无
+ */
+static void oled_i2c_restore(void) {
+    if (oled_i2c_wait_ready())
+        printk(KERN_ERR "%s: I2C panel does not respond after resume\n", SPI_OLED_NAME);
+}
 
-    oled_write_byte(0xAE, OLED_CMD); // 关闭显示 DCDC OFF
-    oled_write_byte(0xD5, OLED_CMD); // 设置时钟分频因子,震荡频率
-    oled_write_byte(80, OLED_CMD);   //[3:0],分频因子;[7:4],震荡频率
-    oled_write_byte(0xA8, OLED_CMD); // 设置驱动路数
-    oled_write_byte(0X3F, OLED_CMD); // 默认0X3F(1/64)
-    oled_write_byte(0xD3, OLED_CMD); // 设置显示偏移
-    oled_write_byte(0X00, OLED_CMD); // 默认为0
+static const struct oled_transport oled_i2c_transport = {
+    .name = "i2c",
+    .restore = oled_i2c_restore,
+    .write_cmds = oled_i2c_write_cmds,
+    .write_window = oled_i2c_write_window,
+};
 
-    oled_write_byte(0x40, OLED_CMD); // 设置显示开始行 [5:0],行数.
+/**
+ * @description : 检查屏幕是否可用（I2C 已绑定或 SPI 的 GPIO 已配置）
+ * @param : 无
+ * @return : 无
+ */
+static bool oled_panel_ready(void) {
+    if (spi_oled_dev.client)
+        return true;
+    return oled_gpio_check();
+}
 
-    oled_write_byte(0x8D, OLED_CMD); // 电荷泵设置，DCDC 命令
-    oled_write_byte(0x14, OLED_CMD); // DCDC ON
-    oled_write_byte(0x20, OLED_CMD); // 设置内存地址模式
-    oled_write_byte(0x02, OLED_CMD); //[1:0],00，列地址模式;01，行地址模式;10,页地址模式;默认10;
-    oled_write_byte(0xA1, OLED_CMD); // 段重定义设置,bit0:0,0->0;1,0->127;
-    oled_write_byte(0xC0, OLED_CMD); // 设置COM扫描方向;bit3:0,普通模式;1,重定义模式 COM[N-1]->COM0;N:驱动路数
-    oled_write_byte(0xDA, OLED_CMD); // 设置COM硬件引脚配置
-    oled_write_byte(0x12, OLED_CMD); //[5:4]配置
+/**
+ * @Description: 通过当前传输接口连续写入多个命令
+ * @param {const uint8_t} *cmds: 命令序列
+ * @param {size_t} len: 命令字节数
+ * @return {*}
+ */
+static void oled_write_cmds(const uint8_t *cmds, size_t len)
+{
+    spi_oled_dev.xfer->write_cmds(cmds, len);
+}
 
-    oled_write_byte(0x81, OLED_CMD); // 对比度设置
-    oled_write_byte(0xEF, OLED_CMD); // 1~255;默认0X7F (亮度设置,越大越亮)
-    oled_write_byte(0xD9, OLED_CMD); // 设置预充电周期
-    oled_write_byte(0xf1, OLED_CMD); //[3:0],PHASE 1;[7:4],PHASE 2;
-    oled_write_byte(0xDB, OLED_CMD); // 设置VCOMH 电压倍率
-    oled_write_byte(0x30, OLED_CMD); //[6:4] 000,0.65*vcc;001,0.77*vcc;011,0.83*vcc;
+/***************************** OLED 初始化 ******************************/
+/* 初始化命令序列（不含开启显示），复位后及唤醒时使用 */
+static const uint8_t oled_init_cmds[] = {
+    0xAE,       // 关闭显示 DCDC OFF
+    0xD5, 80,   // 设置时钟分频因子,震荡频率 [3:0],分频因子;[7:4],震荡频率
+    0xA8, 0X3F, // 设置驱动路数 默认0X3F(1/64)
+    0xD3, 0X00, // 设置显示偏移 默认为0
+
+    0x40,       // 设置显示开始行 [5:0],行数.
+
+    0x8D, 0x14, // 电荷泵设置，DCDC ON
+    0x20, 0x02, // 设置内存地址模式 [1:0],00，列地址模式;01，行地址模式;10,页地址模式;默认10;
+    0xA1,       // 段重定义设置,bit0:0,0->0;1,0->127;（显示方向见 oled_write_orientation）
+    0xC8,       // 设置COM扫描方向;bit3:0,普通模式;1,重定义模式 COM[N-1]->COM0;N:驱动路数
+    0xDA, 0x12, // 设置COM硬件引脚配置 [5:4]配置
+
+    0x81, 0xEF, // 对比度设置 1~255;默认0X7F (亮度设置,越大越亮)
+    0xD9, 0xf1, // 设置预充电周期 [3:0],PHASE 1;[7:4],PHASE 2;
+    0xDB, 0x30, // 设置VCOMH 电压倍率 [6:4] 000,0.65*vcc;001,0.77*vcc;011,0.83*vcc;
+
+    0xA4,       // 全局显示开启;bit0:1,开启;0,关闭;(白屏/黑屏)
+    0xA6,       // 设置显示方式;bit0:1,反相显示;0,正常显示
+};
 
-    oled_write_byte(0xA4, OLED_CMD); // 全局显示开启;bit0:1,开启;0,关闭;(白屏/黑屏)
-    oled_write_byte(0xA6, OLED_CMD); // 设置显示方式;bit0:1,反相显示;0,正常显示
-    oled_write_byte(0xAF, OLED_CMD); // 开启显示
+/**
+ * @description : 写入显示方向命令
+ * @param : 无
+ * @return : 无
+ */
+static void oled_write_orientation(void) {
+    uint8_t cmds[2];
 
+    // 默认 0xA1 + 0xC8：帧缓冲第 0 页第 0 列在左上角，页与字节均按原顺序传输
+    cmds[0] = spi_oled_dev.orientation & OLED_ORIENT_FLIP_H ? 0xA0 : 0xA1;
+    cmds[1] = spi_oled_dev.orientation & OLED_ORIENT_FLIP_V ? 0xC0 : 0xC8;
+    oled_write_cmds(cmds, sizeof(cmds));
+}
+
+/**
+ * @description : OLED 初始化
+ * @param : 无
+ * @return : 无
+ */
+static void oled_start_init(void) {
+    static const uint8_t display_on = 0xAF; // 开启显示
+
+    /* 硬件复位（I2C 模块通常没有 RES 引脚） */
+    if (spi_oled_dev.xfer->reset)
+        spi_oled_dev.xfer->reset();
+
+    oled_write_cmds(oled_init_cmds, sizeof(oled_init_cmds));
+    spi_oled_dev.orientation = orientation & OLED_ORIENT_MASK;
+    oled_write_orientation();
+    oled_write_cmds(&display_on, 1);
+
+    spi_oled_dev.contrast = 0xEF;
+    spi_oled_dev.inverted = false;
+    spi_oled_dev.display_on = true;
+    spi_oled_dev.scrolling = false;     // 复位后滚动已停止
 }
 
 /***************************** OLED 控制函数 ******************************/
@@ -257,47 +557,85 @@ static void oled_start_init(void) {
 /* 屏幕每一列有8字节（64 / 8）数据，共有128列 */
 /* 每一字节行（8行），称为一页，共 8 页 */
 /* 每页的刷新方向为每一字节从上至下，然后每一行从左至右 */ 
+/* 帧缓冲页号即 GDDRAM 页号，方向与镜像由控制器完成 */
+
 /**
- * @description : 刷新 OLED
+ * @description : 标记帧缓冲区域待刷新
+ * @param {unsigned int} x0: 起始列
+ * @param {unsigned int} x1: 结束列（包含）
+ * @param {unsigned int} page0: 起始页
+ * @param {unsigned int} page1: 结束页（包含）
+ * @return {*}
+ */
+static void oled_mark_dirty(unsigned int x0, unsigned int x1, unsigned int page0, unsigned int page1) {
+    struct oled_dirty *d;
+
+    if (x1 >= FRAME_WIDTH)
+        x1 = FRAME_WIDTH - 1;
+    if (page1 >= FRAME_HEIGHT / 8)
+        page1 = FRAME_HEIGHT / 8 - 1;
+    if (x0 > x1 || page0 > page1)
+        return;
+
+    for (unsigned int p = page0; p <= page1; p++) {
+        d = &spi_oled_dev.dirty[p];
+        if (!d->valid) {
+            d->x0 = x0;
+            d->x1 = x1;
+            d->valid = true;
+            continue;
+        }
+        // 与已有范围合并
+        d->x0 = min_t(unsigned int, d->x0, x0);
+        d->x1 = max_t(unsigned int, d->x1, x1);
+    }
+}
+
+/**
+ * @description : 将所有待刷新区域写入屏幕，每页只发送脏列
  * @param : 无
  * @return : 无
  */
-static void refresh_oled(void) {
+static void oled_flush_dirty(void) {
     uint8_t *page_start;
-    // 每一页
-    for (uint8_t i = 0; i < FRAME_HEIGHT / 8; i++) 
-    {
-        oled_write_byte(0xb0 + i, OLED_CMD); // 设置页地址（0~7）
-        oled_write_byte(0x00, OLED_CMD);     // 设置显示位置—列低地址
-        oled_write_byte(0x10, OLED_CMD);     // 设置显示位置—列高地址
 
-        // 计算当前页的起始位置，（0，0）在左上角
-        // page_start = spi_oled_dev.frame_buffer + i * FRAME_WIDTH;
-        // 反转页顺序，如果（0，0）在左下角，则需要先读取最后一页，再读取倒数第二页
-        page_start = spi_oled_dev.frame_buffer + (FRAME_HEIGHT / 8 - 1 - i) * FRAME_WIDTH;
+    for (unsigned int p = 0; p < FRAME_HEIGHT / 8; p++) {
+        struct oled_dirty *d = &spi_oled_dev.dirty[p];
 
-        // 确保不超出 1024 字节的范围
-        if ((i + 1) * FRAME_WIDTH > FRAME_BUFFER_SIZE) {
-            break;
-        }
+        if (!d->valid)
+            continue;
 
-        // 写入当前页的所有字节（从左到右共 128 字节）
-        for (uint8_t n = 0; n < FRAME_WIDTH; n++)
-        {
-            oled_write_byte(page_start[n], OLED_DATA);
-        }
+        page_start = spi_oled_dev.frame_buffer + p * FRAME_WIDTH;
+        spi_oled_dev.xfer->write_window(p, d->x0,
+                                        page_start + d->x0, d->x1 - d->x0 + 1);
+
+        d->valid = false;
     }
 }
 
+/**
+ * @description : 刷新 OLED
+ * @param : 无
+ * @return : 无
+ */
+static void refresh_oled(void) {
+    oled_mark_dirty(0, FRAME_WIDTH - 1, 0, FRAME_HEIGHT / 8 - 1);
+    oled_flush_dirty();
+}
+
 /**
  * @description : 开启 OLED
  * @param : 无
  * @return : 无
  */
 static void open_oled(void) {
-    oled_write_byte(0X8D, OLED_CMD); // SET DCDC命令
-    oled_write_byte(0X14, OLED_CMD); // DCDC ON
-    oled_write_byte(0XAF, OLED_CMD); // DISPLAY ON
+    static const uint8_t cmds[] = {
+        0X8D, // SET DCDC命令
+        0X14, // DCDC ON
+        0XAF, // DISPLAY ON
+    };
+    oled_write_cmds(cmds, sizeof(cmds));
+    spi_oled_dev.display_on = true;
 }
 
 /**
@@ -306,9 +644,13 @@ static void open_oled(void) {
  * @return : 无
  */
 static void close_oled(void) {
-    oled_write_byte(0X8D, OLED_CMD); // SET DCDC命令
-    oled_write_byte(0X10, OLED_CMD); // DCDC OFF
-    oled_write_byte(0XAE, OLED_CMD); // DISPLAY OFF
+    static const uint8_t cmds[] = {
+        0X8D, // SET DCDC命令
+        0X10, // DCDC OFF
+        0XAE, // DISPLAY OFF
+    };
+    oled_write_cmds(cmds, sizeof(cmds));
+    spi_oled_dev.display_on = false;
 }
 
 /**
@@ -322,6 +664,144 @@ static void clear_oled(void) {
 	refresh_oled();//更新显示
 }
 
+/**
+ * @description : 设置显示方向，需持有 spi_oled_dev.lock
+ * @param {unsigned int} flags: OLED_ORIENT_* 组合
+ * @return : 无
+ */
+static void oled_set_orientation(unsigned int flags) {
+    spi_oled_dev.orientation = flags;
+    oled_write_orientation();
+    // 段重映射只作用于之后写入的数据，GDDRAM 中的画面需整屏重写
+    refresh_oled();
+}
+
+/**
+ * @description : 执行单个批量操作，需持有 spi_oled_dev.lock
+ * @param {const struct oled_op} *op: 操作
+ * @return {*} 0 成功，-EINVAL 参数非法
+ */
+static int oled_exec_op(const struct oled_op *op) {
+    uint8_t cmds[9];
+
+    // 区域刷新与清屏只合并脏区域，其它操作执行前先把之前的刷新发送出去，保证顺序
+    if (op->type != OLED_OP_NOP && op->type != OLED_OP_REFRESH && op->type != OLED_OP_CLEAR)
+        oled_flush_dirty();
+
+    switch (op->type) {
+        case OLED_OP_NOP:
+            break;
+        case OLED_OP_DISPLAY_ON:
+            open_oled();
+            break;
+        case OLED_OP_DISPLAY_OFF:
+            close_oled();
+            break;
+        case OLED_OP_CONTRAST:
+            cmds[0] = 0x81;             // 对比度设置
+            cmds[1] = op->arg[0];
+            oled_write_cmds(cmds, 2);
+            spi_oled_dev.contrast = op->arg[0];
+            break;
+        case OLED_OP_INVERT:
+            cmds[0] = op->arg[0] ? 0xA7 : 0xA6; // bit0:1,反相显示;0,正常显示
+            oled_write_cmds(cmds, 1);
+            spi_oled_dev.inverted = !!op->arg[0];
+            break;
+        case OLED_OP_REFRESH:
+            if (op->arg[0] > op->arg[1] || op->arg[1] >= FRAME_WIDTH ||
+                op->arg[2] > op->arg[3] || op->arg[3] >= FRAME_HEIGHT / 8)
+                return -EINVAL;
+            oled_mark_dirty(op->arg[0], op->arg[1], op->arg[2], op->arg[3]);
+            break;
+        case OLED_OP_CLEAR:
+            memset(spi_oled_dev.frame_buffer, 0, FRAME_BUFFER_SIZE);
+            oled_mark_dirty(0, FRAME_WIDTH - 1, 0, FRAME_HEIGHT / 8 - 1);
+            break;
+        case OLED_OP_SCROLL:
+            if (op->arg[0] > 1 || op->arg[1] > op->arg[2] ||
+                op->arg[2] >= FRAME_HEIGHT / 8 || op->arg[3] > 7)
+                return -EINVAL;
+            cmds[0] = 0x2E;                     // 修改滚动参数前必须先停止滚动
+            // 0x26 右滚，0x27 左滚；水平镜像时 GDDRAM 列方向与帧缓冲相反
+            cmds[1] = 0x26 | (op->arg[0] ^ !!(spi_oled_dev.orientation & OLED_ORIENT_FLIP_H));
+            cmds[2] = 0x00;                     // 空字节
+            cmds[3] = op->arg[1];               // 起始页
+            cmds[4] = op->arg[3];               // 帧间隔
+            cmds[5] = op->arg[2];               // 结束页
+            cmds[6] = 0x00;
+            cmds[7] = 0xFF;
+            cmds[8] = 0x2F;                     // 开启滚动
+            oled_write_cmds(cmds, 9);
+            // 保存滚动设置，唤醒后重新开启
+            memcpy(spi_oled_dev.scroll_cmds, cmds, sizeof(spi_oled_dev.scroll_cmds));
+            spi_oled_dev.scrolling = true;
+            break;
+        case OLED_OP_SCROLL_STOP:
+            cmds[0] = 0x2E;
+            oled_write_cmds(cmds, 1);
+            spi_oled_dev.scrolling = false;
+            break;
+        case OLED_OP_RAW_CMD:
+            if (op->len > OLED_OP_ARG_MAX)
+                return -EINVAL;
+            oled_write_cmds(op->arg, op->len);
+            break;
+        case OLED_OP_ORIENTATION:
+            if (op->arg[0] & ~OLED_ORIENT_MASK)
+                return -EINVAL;
+            oled_set_orientation(op->arg[0]);
+            break;
+        default:
+            return -EINVAL;
+    }
+    return 0;
+}
+
+/**
+ * @description : 批量执行操作，只加一次锁
+ * @param {struct oled_batch __user} *ubatch: 用户空间的批量描述
+ * @return {*}
+ */
+static long oled_ioctl_batch(struct oled_batch __user *ubatch) {
+    struct oled_batch batch;
+    struct oled_op *ops;
+    long ret = 0;
+
+    if (copy_from_user(&batch, ubatch, sizeof(batch)))
+        return -EFAULT;
+    if (batch.count == 0)
+        return 0;
+    if (batch.count > OLED_BATCH_MAX)
+        return -E2BIG;
+
+    /* 加锁前先复制全部操作，避免持锁时发生缺页 */
+    ops = memdup_user(u64_to_user_ptr(batch.ops), batch.count * sizeof(struct oled_op));
+    if (IS_ERR(ops))
+        return PTR_ERR(ops);
+
+    mutex_lock(&spi_oled_dev.lock);
+    if (!oled_panel_ready()) {
+        printk(KERN_ERR "%s: Please init GPIO first!\n", SPI_OLED_NAME);
+        ret = -ENODEV;
+        goto unlock;
+    }
+    for (u32 i = 0; i < batch.count; i++) {
+        ret = oled_exec_op(&ops[i]);
+        if (ret < 0) {
+            printk(KERN_ERR "%s: Invalid batch op %u (type %u)\n", SPI_OLED_NAME, i, ops[i].type);
+            break;
+        }
+    }
+    // 出错时前面已执行的操作仍然生效，剩余的刷新一并发送
+    oled_flush_dirty();
+
+unlock:
+    mutex_unlock(&spi_oled_dev.lock);
+    kfree(ops);
+    return ret;
+}
+
 
 /***************************** 字符设备操作集 ******************************/
 /**
@@ -331,21 +811,28 @@ static void clear_oled(void) {
  * @return {*}
  */
 static int oled_open(struct inode *inode, struct file *file) {
+    int ret = 0;
 
     // 如果是第一次打开设备文件，这里会跳过，等待 ioctl 的初始化
     // 如果已经设置过 GPIO，则进行 GPIO 的初始化
-    // 因为每次关闭设备文件，会进行 GPIO 的释放，防止占用
-    if(spi_oled_dev.gpio_group.scl_pin)
+    // 因为最后一个打开者关闭设备文件时会释放 GPIO，防止占用
+    // 设备树/模块参数配置的 GPIO 一直保持占用，无需重新申请
+    // 检查、申请和计数在同一次加锁中完成，两个 open 不会同时申请
+    mutex_lock(&spi_oled_dev.lock);
+    if(spi_oled_dev.gpio_group.scl_pin && !spi_oled_dev.client && !spi_oled_dev.gpio_request_flag)
     {
         /* 初始化 GPIO */
-        int ret = oled_gpio_init();
+        ret = oled_gpio_init();
         if(ret < 0) {
             printk(KERN_ERR "%s: Failed to allocate GPIO\n", SPI_OLED_NAME);
-            return ret;
+            goto unlock;
         }
     }
-        
-    return 0;
+    spi_oled_dev.open_count++;
+
+unlock:
+    mutex_unlock(&spi_oled_dev.lock);
+    return ret;
 }
 
 /**
@@ -355,9 +842,18 @@ static int oled_open(struct inode *inode, struct file *file) {
  * @return {*}
  */
 static int oled_release(struct inode *inode, struct file *file) {
-    printk(KERN_INFO "%s: Closing spi_oled device, free GPIO!\n", SPI_OLED_NAME);
-    /* 取消 GPIO 占用 */
-    oled_gpio_free();
+    mutex_lock(&spi_oled_dev.lock);
+    // 其他打开者（如 app）仍在使用时不释放 GPIO，也保留其他写入者的半帧
+    if (--spi_oled_dev.open_count == 0) {
+        /* 丢弃未写满的帧流数据 */
+        spi_oled_dev.stream_fill = 0;
+        /* 取消 GPIO 占用 */
+        if (!spi_oled_dev.gpio_persistent && spi_oled_dev.gpio_request_flag) {
+            printk(KERN_INFO "%s: Closing spi_oled device, free GPIO!\n", SPI_OLED_NAME);
+            oled_gpio_free();
+        }
+    }
+    mutex_unlock(&spi_oled_dev.lock);
     return 0;
 }
 
@@ -370,6 +866,7 @@ static int oled_release(struct inode *inode, struct file *file) {
  * @return {*}
  */
 static ssize_t oled_read(struct file *file, char __user *user_buffer, size_t count, loff_t *offset) {
+    static const char * const orientation_names[] = { "normal", "flip h", "flip v", "rotate 180" };
     char *usage_info;
     size_t len;
 
@@ -377,8 +874,20 @@ static ssize_t oled_read(struct file *file, char __user *user_buffer, size_t cou
     usage_info = kasprintf(GFP_KERNEL,
         "Device Information:\n"
         "  Resolution: %d * %d\n"
-        "  Buffer size: %ld Byte\n",
-        FRAME_WIDTH, FRAME_HEIGHT, buffer_size);
+        "  Buffer size: %ld Byte\n"
+        "  Transport: %s\n"
+        "  Orientation: %s\n"
+        "Statistics:\n"
+        "  Stream fps: %llu\n"
+        "  Stream frames: %llu\n"
+        "  Stream late frames: %llu\n"
+        "  Resume count: %llu\n"
+        "  Resume to first pixel: %lld us\n",
+        FRAME_WIDTH, FRAME_HEIGHT, buffer_size, spi_oled_dev.xfer->name,
+        orientation_names[spi_oled_dev.orientation],
+        spi_oled_dev.frame_period_ns ? div64_u64(NSEC_PER_SEC, spi_oled_dev.frame_period_ns) : 0,
+        spi_oled_dev.stats.stream_frames, spi_oled_dev.stats.stream_late,
+        spi_oled_dev.stats.resume_count, spi_oled_dev.stats.resume_latency_us);
 
     if (!usage_info) {
         return -ENOMEM;  // 内存分配失败
@@ -409,60 +918,123 @@ static ssize_t oled_read(struct file *file, char __user *user_buffer, size_t cou
 }
 
 /**
- * @Description: 用户空间 write 函数，可以直接写入到帧缓冲
- * @param {file} *file: 文件结构体指针
- * @param {char __user} *user_buffer: 用户空间的内存地址
- * @param {size_t} count: 要写的长度
- * @param {loff_t} *offset: 写的位置相对于文件开头的偏移
+ * @Description: 等待帧流的下一个显示时刻，实现背压
+ * @param {bool} nonblock: 非阻塞写入时不等待
+ * @return {*} 0 可以显示，-EAGAIN 未到时刻，-ERESTARTSYS 被信号打断
+ */
+static int oled_stream_wait(bool nonblock) {
+    ktime_t deadline = READ_ONCE(spi_oled_dev.next_frame);
+
+    if (!READ_ONCE(spi_oled_dev.frame_period_ns))
+        return 0;
+
+    while (ktime_before(ktime_get(), deadline)) {
+        if (nonblock)
+            return -EAGAIN;
+        // 休眠到预定时刻，允许 50us 的合并误差
+        set_current_state(TASK_INTERRUPTIBLE);
+        if (schedule_hrtimeout_range(&deadline, 50 * NSEC_PER_USEC, HRTIMER_MODE_ABS) == -EINTR)
+            return -ERESTARTSYS;
+    }
+    return 0;
+}
+
+/**
+ * @Description: 显示帧流中已经完整写入的一帧，需持有 spi_oled_dev.lock
  * @return {*}
  */
-static ssize_t oled_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos) { 
-    bool ret;
+static void oled_stream_present(void) {
+    u64 period = spi_oled_dev.frame_period_ns;
+    ktime_t now, base;
+    s64 behind;
+
+    refresh_oled();
+    spi_oled_dev.stats.stream_frames++;
+
+    if (!period)
+        return;
+
+    // 按固定周期推进，避免累积误差
+    now = ktime_get();
+    base = spi_oled_dev.next_frame;
+    behind = ktime_to_ns(ktime_sub(now, base));
+    if (behind > (s64)period) {
+        // 预定时刻已过去超过一个周期：写入方空闲过（新的帧流），从现在重新对齐，不算迟到，也避免之后连续突发
+        base = now;
+    } else if (behind > (s64)(period / 2)) {
+        spi_oled_dev.stats.stream_late++;
+    }
+    spi_oled_dev.next_frame = ktime_add_ns(base, period);
+}
+
+/**
+ * @Description: 用户空间 write/splice 入口，数据按 1024 字节整帧依次显示
+ *               支持 splice()/sendfile() 直接把帧文件送入设备，按设定帧率阻塞写入者
+ * @param {struct kiocb} *iocb: IO 控制块
+ * @param {struct iov_iter} *from: 待写入的数据
+ * @return {*} 实际写入的字节数
+ */
+static ssize_t oled_write_iter(struct kiocb *iocb, struct iov_iter *from) {
+    bool nonblock = (iocb->ki_filp->f_flags & O_NONBLOCK) || (iocb->ki_flags & IOCB_NOWAIT);
+    size_t done = 0;
+    int ret = 0;
+
     /* 检查是否已经配置 GPIO */
-    ret = oled_gpio_check();
-    if (ret == false)
-    {
+    if (!oled_panel_ready()) {
         printk(KERN_ERR "%s: Please init GPIO first!\n", SPI_OLED_NAME);
         return -ENODEV;
     }
 
-    // 检查写入大小是否合法
-    if (count > buffer_size) {
-        printk(KERN_ERR "%s: ERROR! Write size %zu exceeds buffer size %ld\n", SPI_OLED_NAME, count, buffer_size);
-        return -EINVAL;
-    }
+    while (iov_iter_count(from)) {
+        size_t fill, n;
+
+        // 帧内偏移只在持锁时读取和更新，多个写入者不会丢失或重复半帧数据
+        mutex_lock(&spi_oled_dev.lock);
+        fill = spi_oled_dev.stream_fill;
+        n = min_t(size_t, FRAME_BUFFER_SIZE - fill, iov_iter_count(from));
+
+        // 这次写入会凑满一帧，先等到显示时刻再接收，写入者因此被限速
+        // 等待时不持锁，醒来后重新读取偏移
+        if (fill + n == FRAME_BUFFER_SIZE && oled_stream_wait(true)) {
+            mutex_unlock(&spi_oled_dev.lock);
+            ret = oled_stream_wait(nonblock);
+            if (ret)
+                break;
+            continue;
+        }
 
-    // 将数据从用户空间复制到帧缓冲
-    // copy_from_user 的 size 参数传入的是块大小（单次写入的大小）
-    if (copy_from_user(spi_oled_dev.frame_buffer + *ppos, buf, count)) {
-        printk(KERN_ERR "%s: Failed to copy data from user space\n", SPI_OLED_NAME);
-        return -EFAULT;
+        // 直接复制到帧缓冲，不经过中间缓冲区
+        if (copy_from_iter(spi_oled_dev.frame_buffer + fill, n, from) != n) {
+            mutex_unlock(&spi_oled_dev.lock);
+            ret = -EFAULT;
+            break;
+        }
+        fill += n;
+        done += n;
+        if (fill == FRAME_BUFFER_SIZE) {
+            oled_stream_present();
+            fill = 0;
+        }
+        spi_oled_dev.stream_fill = fill;
+        mutex_unlock(&spi_oled_dev.lock);
     }
 
-    // 刷新屏幕
-    refresh_oled();
-
-    // 更新文件位置
-    *ppos = 0;
-
-    printk(KERN_INFO "%s: Write succeeded: count=%zu, pos=%lld\n", SPI_OLED_NAME, count, *ppos);
-    return count;
+    // 已经写入部分数据时返回字节数，否则返回错误
+    return done ? done : ret;
 }
 
-
 /**
- * @Description: 用户空间 ioctl 函数
- * @param {file} *file: 文件结构体指针
+ * @Description: 处理单条 ioctl 命令，需持有 spi_oled_dev.lock
  * @param {unsigned int} cmd: 用户程序对设备的控制命令
  * @param {unsigned long} arg: 传输的数据
  * @return {*}
  */
-static long oled_ioctl(struct file *file, unsigned int cmd, unsigned long arg) {
+static long oled_ioctl_locked(unsigned int cmd, unsigned long arg) {
     bool ret;
     /* 检查是否已经配置 GPIO */
     if (cmd != IOCTL_OLED_SET_GPIO)
     {
-        ret = oled_gpio_check();
+        ret = oled_panel_ready();
         if (ret == false)
         {
             printk(KERN_ERR "%s: Please init GPIO first!\n", SPI_OLED_NAME);
@@ -477,7 +1049,7 @@ static long oled_ioctl(struct file *file, unsigned int cmd, unsigned long arg) {
             int ret;
 
             /* 检查是否已经配置 GPIO */
-            ret = oled_gpio_check();
+            ret = oled_panel_ready();
             if (ret == true)
             {
                 printk(KERN_INFO "%s: GPIO has been configured. Nothing to do.\n", SPI_OLED_NAME);
@@ -527,6 +1099,29 @@ static long oled_ioctl(struct file *file, unsigned int cmd, unsigned long arg) {
             // printk(KERN_INFO "%s: OLED refreshed\n", SPI_OLED_NAME);
             clear_oled();
             break;
+        /* 设置帧流帧率 */
+        case IOCTL_OLED_SET_FPS: {
+            __u32 fps;
+
+            if (copy_from_user(&fps, (void __user *)arg, sizeof(fps)))
+                return -EFAULT;
+            if (fps > 1000)
+                return -EINVAL;
+            spi_oled_dev.frame_period_ns = fps ? NSEC_PER_SEC / fps : 0;
+            spi_oled_dev.next_frame = ktime_get();
+            break;
+        }
+        /* 设置显示方向 */
+        case IOCTL_OLED_SET_ORIENTATION: {
+            __u32 flags;
+
+            if (copy_from_user(&flags, (void __user *)arg, sizeof(flags)))
+                return -EFAULT;
+            if (flags & ~OLED_ORIENT_MASK)
+                return -EINVAL;
+            oled_set_orientation(flags);
+            break;
+        }
         default:
             printk(KERN_ERR "%s: Unknown command!\n", SPI_OLED_NAME);
             return -ENOTTY;
@@ -535,6 +1130,26 @@ static long oled_ioctl(struct file *file, unsigned int cmd, unsigned long arg) {
     return 0;
 }
 
+/**
+ * @Description: 用户空间 ioctl 函数
+ * @param {file} *file: 文件结构体指针
+ * @param {unsigned int} cmd: 用户程序对设备的控制命令
+ * @param {unsigned long} arg: 传输的数据
+ * @return {*}
+ */
+static long oled_ioctl(struct file *file, unsigned int cmd, unsigned long arg) {
+    long ret;
+
+    /* 批量操作需要先复制参数，内部自行加锁 */
+    if (cmd == IOCTL_OLED_BATCH)
+        return oled_ioctl_batch((struct oled_batch __user *)arg);
+
+    mutex_lock(&spi_oled_dev.lock);
+    ret = oled_ioctl_locked(cmd, arg);
+    mutex_unlock(&spi_oled_dev.lock);
+    return ret;
+}
+
 /**
  * @Description: 用于映射 oled 帧缓冲
  * @param {file} *filp: 指向文件对象的指针
@@ -579,11 +1194,339 @@ static const struct file_operations spi_oled_fops = {
     .open = oled_open,
     .release = oled_release,
     .read = oled_read,
-    .write = oled_write,
+    .write_iter = oled_write_iter,
+    .splice_write = iter_file_splice_write,
     .unlocked_ioctl = oled_ioctl,
     .mmap = oled_mmap,
 };
 
+/***************************** 电源管理 ******************************/
+/**
+ * @description : 系统休眠，关闭显示和电荷泵，帧缓冲保留在内存中
+ * @param {struct device} *dev: 设备
+ * @return {*}
+ */
+static int oled_pm_suspend(struct device *dev) {
+    mutex_lock(&spi_oled_dev.lock);
+    // 模块已加载而 app 还没有配置屏幕是正常状态，不用 oled_panel_ready()，避免每次休眠都打印错误
+    if (spi_oled_dev.gpio_request_flag || spi_oled_dev.client) {
+        bool was_on = spi_oled_dev.display_on;
+
+        close_oled();
+        // 保留休眠前的显示状态，唤醒时按原状态恢复
+        spi_oled_dev.display_on = was_on;
+        spi_oled_dev.suspended = true;
+    }
+    mutex_unlock(&spi_oled_dev.lock);
+    return 0;
+}
+
+/**
+ * @description : 系统唤醒，重放初始化命令并一次性写回帧缓冲，不等待用户空间重绘
+ *                OLED_OP_SCROLL 开启的滚动也会恢复（OLED_OP_RAW_CMD 直接发送的命令不会重放）
+ * @param {struct device} *dev: 设备
+ * @return {*}
+ */
+static int oled_pm_resume(struct device *dev) {
+    ktime_t start = ktime_get();
+    uint8_t cmds[3];
+
+    mutex_lock(&spi_oled_dev.lock);
+    if (!spi_oled_dev.suspended)
+        goto unlock;
+
+    // 屏幕可能已掉电，无需复位脉冲，重放全部寄存器配置即可
+    if (spi_oled_dev.xfer->restore)
+        spi_oled_dev.xfer->restore();
+    oled_write_cmds(oled_init_cmds, sizeof(oled_init_cmds));
+    cmds[0] = 0x81;                                 // 恢复对比度
+    cmds[1] = spi_oled_dev.contrast;
+    cmds[2] = spi_oled_dev.inverted ? 0xA7 : 0xA6;  // 恢复反相设置
+    oled_write_cmds(cmds, sizeof(cmds));
+    oled_write_orientation();                       // 恢复显示方向
+
+    // 先写回画面再开启显示，避免闪现 GDDRAM 中的旧数据
+    refresh_oled();
+    // 写完 GDDRAM 后再恢复硬件滚动（滚动期间不应写入显存）
+    if (spi_oled_dev.scrolling)
+        oled_write_cmds(spi_oled_dev.scroll_cmds, sizeof(spi_oled_dev.scroll_cmds));
+    if (spi_oled_dev.display_on)
+        open_oled();
+
+    spi_oled_dev.suspended = false;
+    spi_oled_dev.stats.resume_count++;
+    spi_oled_dev.stats.resume_latency_us = ktime_us_delta(ktime_get(), start);
+
+unlock:
+    mutex_unlock(&spi_oled_dev.lock);
+    return 0;
+}
+
+/* 挂在设备类上，app 配置和板级配置的屏幕都会收到休眠/唤醒回调 */
+static SIMPLE_DEV_PM_OPS(oled_pm_ops, oled_pm_suspend, oled_pm_resume);
+
+/***************************** 板级配置 ******************************/
+/* 设备树示例：
+ *   oled {
+ *       compatible = "lrf,spi-oled";
+ *       scl-gpios = <&gpio3 RK_PA2 GPIO_ACTIVE_HIGH>;
+ *       mosi-gpios = <&gpio3 RK_PA5 GPIO_ACTIVE_HIGH>;
+ *       res-gpios = <&gpio3 RK_PA4 GPIO_ACTIVE_HIGH>;
+ *       dc-gpios = <&gpio3 RK_PA3 GPIO_ACTIVE_HIGH>;
+ *       firmware-name = "spi_oled_splash.bin";  // 可选
+ *   };
+ */
+static const char * const oled_gpio_props[PIN_NUM] = {
+    "scl-gpios", "mosi-gpios", "res-gpios", "dc-gpios"
+};
+
+/**
+ * @description : 绘制内置开机画面（双线边框 + 中间进度条）
+ * @param : 无
+ * @return : 无
+ */
+static void oled_draw_builtin_splash(void) {
+    uint8_t *fb = spi_oled_dev.frame_buffer;
+    unsigned int x, y;
+
+    memset(fb, 0, FRAME_BUFFER_SIZE);
+    for (x = 0; x < FRAME_WIDTH; x++) {
+        for (y = 0; y < FRAME_HEIGHT; y++) {
+            bool outer = x == 0 || y == 0 || x == FRAME_WIDTH - 1 || y == FRAME_HEIGHT - 1;
+            bool inner = (x == 3 || x == FRAME_WIDTH - 4) && y >= 3 && y <= FRAME_HEIGHT - 4;
+            bool bar = x >= 24 && x < FRAME_WIDTH - 24 && y >= 29 && y <= 34;
+
+            inner |= (y == 3 || y == FRAME_HEIGHT - 4) && x >= 3 && x <= FRAME_WIDTH - 4;
+            if (outer || inner || bar)
+                fb[(y / 8) * FRAME_WIDTH + x] |= OLED_PIXEL_MASK(y);
+        }
+    }
+}
+
+/**
+ * @description : 使用板级配置初始化屏幕并显示开机画面，之后 app 可直接接管
+ * @param {const int} *pins: SPI 引脚号，顺序为 scl, mosi, res, dc；I2C 屏幕传 NULL
+ * @param {struct i2c_client} *client: I2C 屏幕，SPI 屏幕传 NULL
+ * @param {const char} *fw_name: 开机画面固件名，可为 NULL
+ * @param {struct device} *dev: 用于加载固件的设备
+ * @return {*}
+ */
+static int oled_panel_setup(const int *pins, struct i2c_client *client, const char *fw_name, struct device *dev) {
+    const struct firmware *fw = NULL;
+    int ret = 0;
+
+    /* 加锁前加载固件，固件不存在时不报警告 */
+    if (fw_name && *fw_name && firmware_request_nowarn(&fw, fw_name, dev))
+        fw = NULL;
+
+    mutex_lock(&spi_oled_dev.lock);
+    if (oled_panel_ready()) {
+        printk(KERN_ERR "%s: Panel has already been configured\n", SPI_OLED_NAME);
+        ret = -EBUSY;
+        goto unlock;
+    }
+
+    if (client) {
+        spi_oled_dev.client = client;
+        spi_oled_dev.xfer = &oled_i2c_transport;
+        ret = oled_i2c_wait_ready();
+        if (ret < 0) {
+            printk(KERN_ERR "%s: I2C panel at 0x%02x does not respond\n", SPI_OLED_NAME, client->addr);
+            // 不保留指向 client 的指针，remove 不会被调用
+            spi_oled_dev.client = NULL;
+            spi_oled_dev.xfer = &oled_spi_transport;
+            goto unlock;
+        }
+    } else {
+        spi_oled_dev.gpio_group.scl_pin = pins[0];
+        spi_oled_dev.gpio_group.mosi_pin = pins[1];
+        spi_oled_dev.gpio_group.res_pin = pins[2];
+        spi_oled_dev.gpio_group.dc_pin = pins[3];
+        ret = oled_gpio_init();
+        if (ret < 0) {
+            printk(KERN_ERR "%s: Failed to allocate GPIO\n", SPI_OLED_NAME);
+            // 清除无效的引脚，否则 open 会反复申请并失败，app 也无法再用 ioctl 配置
+            memset(&spi_oled_dev.gpio_group, 0, sizeof(spi_oled_dev.gpio_group));
+            goto unlock;
+        }
+        spi_oled_dev.gpio_persistent = true;
+        spi_oled_dev.xfer = &oled_spi_transport;
+    }
+
+    oled_start_init();
+
+    if (fw && fw->size == FRAME_BUFFER_SIZE) {
+        memcpy(spi_oled_dev.frame_buffer, fw->data, FRAME_BUFFER_SIZE);
+    } else {
+        if (fw)
+            printk(KERN_WARNING "%s: Splash %s is %zu bytes, expected %d\n",
+                   SPI_OLED_NAME, fw_name, fw->size, FRAME_BUFFER_SIZE);
+        oled_draw_builtin_splash();
+    }
+    refresh_oled();
+    printk(KERN_INFO "%s: Panel initialized at probe time (%s)\n", SPI_OLED_NAME, spi_oled_dev.xfer->name);
+
+unlock:
+    mutex_unlock(&spi_oled_dev.lock);
+    release_firmware(fw);
+    return ret;
+}
+
+/**
+ * @description : 关闭板级配置的屏幕，释放引脚或解除 I2C 绑定
+ * @param : 无
+ * @return : 无
+ */
+static void oled_panel_teardown(void) {
+    mutex_lock(&spi_oled_dev.lock);
+    if (spi_oled_dev.client) {
+        close_oled();
+        spi_oled_dev.client = NULL;
+        spi_oled_dev.xfer = &oled_spi_transport;
+    } else if (spi_oled_dev.gpio_persistent) {
+        close_oled();
+        oled_gpio_free();
+        spi_oled_dev.gpio_persistent = false;
+    }
+    mutex_unlock(&spi_oled_dev.lock);
+}
+
+/**
+ * @description : 平台设备 probe，从设备树读取引脚
+ * @param {struct platform_device} *pdev: 平台设备
+ * @return {*}
+ */
+static int oled_platform_probe(struct platform_device *pdev) {
+    struct device_node *np = pdev->dev.of_node;
+    const char *fw_name = NULL;
+    int pins[PIN_NUM];
+
+    for (int i = 0; i < PIN_NUM; i++) {
+        pins[i] = of_get_named_gpio(np, oled_gpio_props[i], 0);
+        if (!gpio_is_valid(pins[i]))
+            return dev_err_probe(&pdev->dev, pins[i], "invalid %s\n", oled_gpio_props[i]);
+    }
+    of_property_read_string(np, "firmware-name", &fw_name);
+
+    return oled_panel_setup(pins, NULL, fw_name, &pdev->dev);
+}
+
+/**
+ * @description : 平台设备 remove
+ * @param {struct platform_device} *pdev: 平台设备
+ * @return {*}
+ */
+static int oled_platform_remove(struct platform_device *pdev) {
+    oled_panel_teardown();
+    return 0;
+}
+
+static const struct of_device_id oled_of_match[] = {
+    { .compatible = "lrf,spi-oled" },
+    { /* sentinel */ }
+};
+MODULE_DEVICE_TABLE(of, oled_of_match);
+
+static struct platform_driver oled_platform_driver = {
+    .probe = oled_platform_probe,
+    .remove = oled_platform_remove,
+    .driver = {
+        .name = SPI_OLED_NAME,
+        .of_match_table = oled_of_match,
+    },
+};
+
+/***************************** I2C 屏幕 ******************************/
+/* 可用 i2c-stub 测试：
+ *   modprobe i2c-stub chip_addr=0x3c
+ *   echo spi_oled_i2c 0x3c > /sys/bus/i2c/devices/i2c-N/new_device
+ */
+/**
+ * @description : I2C 设备 probe，与 SPI 屏幕共用同一个字符设备
+ * @param {struct i2c_client} *client: I2C 设备
+ * @return {*}
+ */
+static int oled_i2c_probe(struct i2c_client *client) {
+    const char *fw_name = splash;
+
+    if (!i2c_check_functionality(client->adapter, I2C_FUNC_I2C) &&
+        !i2c_check_functionality(client->adapter, I2C_FUNC_SMBUS_WRITE_I2C_BLOCK))
+        return dev_err_probe(&client->dev, -ENODEV, "adapter supports neither I2C nor SMBus block writes\n");
+
+    if (client->dev.of_node)
+        of_property_read_string(client->dev.of_node, "firmware-name", &fw_name);
+
+    return oled_panel_setup(NULL, client, fw_name, &client->dev);
+}
+
+/**
+ * @description : I2C 设备 remove
+ * @param {struct i2c_client} *client: I2C 设备
+ * @return {*}
+ */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 1, 0)
+static void oled_i2c_remove(struct i2c_client *client) {
+    if (spi_oled_dev.client == client)
+        oled_panel_teardown();
+}
+#else
+static int oled_i2c_remove(struct i2c_client *client) {
+    if (spi_oled_dev.client == client)
+        oled_panel_teardown();
+    return 0;
+}
+#endif
+
+static const struct i2c_device_id oled_i2c_id[] = {
+    { "spi_oled_i2c", 0 },
+    { /* sentinel */ }
+};
+MODULE_DEVICE_TABLE(i2c, oled_i2c_id);
+
+static const struct of_device_id oled_i2c_of_match[] = {
+    { .compatible = "lrf,ssd1306-i2c" },
+    { /* sentinel */ }
+};
+MODULE_DEVICE_TABLE(of, oled_i2c_of_match);
+
+static struct i2c_driver oled_i2c_driver = {
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0)
+    .probe = oled_i2c_probe,        // 6.3 起 probe 只有 client 一个参数，probe_new 之后被移除
+#else
+    .probe_new = oled_i2c_probe,
+#endif
+    .remove = oled_i2c_remove,
+    .id_table = oled_i2c_id,
+    .driver = {
+        .name = "spi_oled_i2c",
+        .of_match_table = oled_i2c_of_match,
+    },
+};
+
+/**
+ * @description : sysfs 属性 /sys/class/spi_oled/spi_oled/panel_ready，驱动已在加载/probe 时初始化屏幕时为 1
+ *                run_app.sh 据此决定是否向 app 传递引脚
+ * @param {struct device} *dev: 设备
+ * @param {struct device_attribute} *attr: 属性
+ * @param {char} *buf: 输出缓冲
+ * @return {*}
+ */
+static ssize_t panel_ready_show(struct device *dev, struct device_attribute *attr, char *buf) {
+    bool ready;
+
+    mutex_lock(&spi_oled_dev.lock);
+    ready = spi_oled_dev.gpio_persistent || spi_oled_dev.client;
+    mutex_unlock(&spi_oled_dev.lock);
+    return sysfs_emit(buf, "%d\n", ready);
+}
+static DEVICE_ATTR_RO(panel_ready);
+
+static struct attribute *oled_attrs[] = {
+    &dev_attr_panel_ready.attr,
+    NULL,
+};
+ATTRIBUTE_GROUPS(oled);
+
 /***************************** 字符设备初始化 ******************************/
 /**
  * @description : 驱动模块加载函数
@@ -613,6 +1556,10 @@ static int __init oled_driver_init(void) {
         goto free_gpio;
     }
     memset(spi_oled_dev.frame_buffer, 0, buffer_size);
+    mutex_init(&spi_oled_dev.lock);
+    spi_oled_dev.xfer = &oled_spi_transport;
+    spi_oled_dev.frame_period_ns = stream_fps ? NSEC_PER_SEC / stream_fps : 0;
+    spi_oled_dev.next_frame = ktime_get();
     
     /************ 注册字符设备驱动 ************/
     /* 1、创建设备号 */
@@ -649,6 +1596,8 @@ static int __init oled_driver_init(void) {
     if (IS_ERR(spi_oled_dev.class)) {
         goto del_cdev;
     }
+    spi_oled_dev.class->pm = &oled_pm_ops;
+    spi_oled_dev.class->dev_groups = oled_groups;
 
     /* 5、创建设备 */
     spi_oled_dev.device = device_create(spi_oled_dev.class, NULL, spi_oled_dev.devid, NULL, SPI_OLED_NAME);
@@ -656,9 +1605,37 @@ static int __init oled_driver_init(void) {
         goto destroy_class;
     }
 
+    /************ 板级配置 ************/
+    /* 模块参数指定了引脚，加载时直接初始化屏幕 */
+    if (gpios_num == PIN_NUM) {
+        if (oled_panel_setup(gpios, NULL, splash, spi_oled_dev.device) < 0)
+            printk(KERN_WARNING "%s: Failed to init panel from module parameters\n", SPI_OLED_NAME);
+    } else if (gpios_num) {
+        printk(KERN_WARNING "%s: gpios needs %d values, got %d\n", SPI_OLED_NAME, PIN_NUM, gpios_num);
+    }
+
+    /* 设备树描述的屏幕在 probe 时初始化 */
+    ret = platform_driver_register(&oled_platform_driver);
+    if (ret < 0) {
+        printk(KERN_ERR "%s: Failed to register platform driver\n", SPI_OLED_NAME);
+        goto destroy_device;
+    }
+
+    /* I2C 屏幕在 I2C 设备 probe 时初始化 */
+    ret = i2c_add_driver(&oled_i2c_driver);
+    if (ret < 0) {
+        printk(KERN_ERR "%s: Failed to register i2c driver\n", SPI_OLED_NAME);
+        goto unregister_platform;
+    }
+
     printk(KERN_INFO "%s: spi_oled driver is loaded!\n", SPI_OLED_NAME);
     return 0;
 
+unregister_platform:
+    platform_driver_unregister(&oled_platform_driver);
+destroy_device:
+    oled_panel_teardown();
+    device_destroy(spi_oled_dev.class, spi_oled_dev.devid);
 destroy_class:
     class_destroy(spi_oled_dev.class);
 del_cdev:
@@ -679,6 +1656,11 @@ free_gpio:
  */
 static void __exit oled_driver_exit(void) {
 
+    /* 注销 I2C 驱动和平台驱动 */
+    i2c_del_driver(&oled_i2c_driver);
+    platform_driver_unregister(&oled_platform_driver);
+    oled_panel_teardown();
+
     /* 注销字符设备驱动 */
     device_destroy(spi_oled_dev.class, spi_oled_dev.devid);     /* 注销设备 */
     class_destroy(spi_oled_dev.class);                          /* 注销类 */